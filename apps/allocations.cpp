@@ -0,0 +1,60 @@
+#include "allocations.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#if EULER_COUNT_ALLOCATIONS
+
+namespace {  // anonymous
+
+std::atomic<std::uint64_t> allocation_count(0);
+std::atomic<std::uint64_t> allocation_bytes(0);
+
+void* allocate(std::size_t size) noexcept {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  allocation_bytes.fetch_add(size, std::memory_order_relaxed);
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+}  // namespace
+
+// Defined here rather than next to their callers, so that calls to free are never inlined into
+// code that GCC sees allocating with new, which it would flag with -Wmismatched-new-delete
+void* operator new(std::size_t size) {
+  void* p = allocate(size);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete[](void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+#endif
+
+namespace euler {
+
+AllocationTotals countedAllocations() {
+#if EULER_COUNT_ALLOCATIONS
+  return {allocation_count.load(std::memory_order_relaxed),
+          allocation_bytes.load(std::memory_order_relaxed)};
+#else
+  return {0, 0};
+#endif
+}
+
+}  // namespace euler
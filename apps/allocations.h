@@ -0,0 +1,36 @@
+#ifndef EULER_APPS_ALLOCATIONS_H
+#define EULER_APPS_ALLOCATIONS_H
+
+#include <euler/instrument.h>
+
+#include <cstdint>
+
+/// Set to 1 to count allocations even with the instrumentation compiled out, as the benchmarks do
+#ifndef EULER_COUNT_ALLOCATIONS
+#define EULER_COUNT_ALLOCATIONS EULER_INSTRUMENTATION
+#endif
+
+namespace euler {
+
+/**
+ * @brief Totals of the allocations made through operator new
+ */
+struct AllocationTotals {
+  std::uint64_t count;
+  std::uint64_t bytes;
+};
+
+/**
+ * @brief Returns the totals of the allocations made through operator new since the program started,
+ * by any thread
+ *
+ * @details Programs that link allocations.cpp have every form of the global operator new and delete
+ * replaced by counting versions on top of std::malloc and std::free, so the totals include the
+ * allocations of the library and of the standard library. Without EULER_COUNT_ALLOCATIONS the
+ * replacements are compiled out, so allocations cost nothing extra, and the totals stay zero.
+ */
+AllocationTotals countedAllocations();
+
+}  // namespace euler
+
+#endif
@@ -1,14 +1,432 @@
+#include <euler/binary.h>
+#include <euler/instrument.h>
 #include <euler/io.h>
+#include <euler/npy.h>
+#include <euler/parallel.h>
 #include <euler/rotations.h>
+#include <euler/server.h>
+#include <euler/shm.h>
+#include <euler/trace.h>
+
+#include "allocations.h"
+#include "pipeline.h"
 
 #include <argagg/argagg.hpp>
 
+#include <chrono>
 #include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
+#include <sstream>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
 
 using namespace euler;
 
+namespace {  // anonymous
+
+/// Number of records converted together when streaming, per thread
+const std::size_t STREAM_BATCH_SIZE = 4096;
+
+/**
+ * @brief std::fread, recorded in the trace
+ */
+std::size_t tracedRead(void* data, std::size_t size, std::size_t count, std::FILE* in) {
+  const TraceScope scope("read", "io");
+  return std::fread(data, size, count, in);
+}
+
+/**
+ * @brief std::fwrite, recorded in the trace
+ */
+std::size_t tracedWrite(const void* data, std::size_t size, std::size_t count, std::FILE* out) {
+  const TraceScope scope("write", "io");
+  return std::fwrite(data, size, count, out);
+}
+
+/**
+ * @brief Flushes an output file, closing it unless it is standard output
+ *
+ * @return True if everything written to the file reached it
+ */
+bool closeOutput(std::FILE* out) {
+  bool written = std::fflush(out) == 0 && !std::ferror(out);
+  if (out != stdout) {
+    written = std::fclose(out) == 0 && written;
+  }
+  return written;
+}
+
+/**
+ * @brief Reports that an output file (- for standard output) could not be written
+ *
+ * @return -1, the exit status
+ */
+int writeError(const std::string& output) {
+  std::cerr << "Error: Cannot write "
+            << (output == "-" ? std::string("standard output") : "output file " + output) << "."
+            << std::endl;
+  return -1;
+}
+
+/**
+ * @brief Determines if an input (- for standard input) and an output path name the same file
+ */
+bool sameFile(const std::string& input, const std::string& output) {
+  struct stat in, out;
+  if (output == "-" || ::stat(output.c_str(), &out) != 0) {
+    return false;
+  }
+  const int result = input == "-" ? ::fstat(STDIN_FILENO, &in) : ::stat(input.c_str(), &in);
+  return result == 0 && in.st_dev == out.st_dev && in.st_ino == out.st_ino;
+}
+
+/**
+ * @brief Converts angles from degrees to radians in place
+ */
+void toRadians(Angles* angles, std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) {
+    std::for_each(angles[i].begin(), angles[i].end(), [](double& x) { x *= M_PI / 180; });
+  }
+}
+
+/**
+ * @brief Converts every batch of angles and writes one line per set of angles
+ *
+ * @details Each line holds the nine elements of the rotation matrix in row-major order followed
+ * by the four elements of the unit quaternion (w, x, y, z). Chunks of the batch are converted and
+ * formatted into their own buffers on the threads of the pool, then written in order.
+ *
+ * @return False if the lines could not be written
+ */
+bool writeBatch(std::FILE* out, Sequence sequence, Convention convention,
+                const Angles* angles, std::size_t count, ThreadPool& pool,
+                std::vector<std::vector<char>>& buffers) {
+  const std::size_t chunks = (count + PARALLEL_CHUNK_SIZE - 1) / PARALLEL_CHUNK_SIZE;
+  if (buffers.size() < chunks) {
+    buffers.resize(chunks);
+  }
+  std::vector<std::size_t> sizes(chunks);
+
+  pool.parallelFor(count, PARALLEL_CHUNK_SIZE, [&](std::size_t begin, std::size_t end) {
+    const std::size_t n = end - begin;
+    std::vector<RotationMatrix> R(n);
+    std::vector<Quaternion> q(n);
+    toRotationMatrix(sequence, angles + begin, n, convention, R.data());
+    toQuaternion(sequence, angles + begin, n, convention, q.data());
+    const std::size_t c = begin / PARALLEL_CHUNK_SIZE;
+    sizes[c] = formatLines(R.data(), q.data(), n, buffers[c]);
+  });
+
+  for (std::size_t c = 0; c < chunks; ++c) {
+    if (tracedWrite(buffers[c].data(), 1, sizes[c], out) != sizes[c]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Converts angles, in degrees unless radians is set, into binary records on the threads of
+ * a pool
+ */
+void convertBlock(Sequence sequence, Convention convention, bool radians,
+                  const Angles* angles, std::size_t count, BinaryRecord* out, ThreadPool& pool) {
+  pool.parallelFor(count, PARALLEL_CHUNK_SIZE, [&](std::size_t begin, std::size_t end) {
+    const Angles* a = angles + begin;
+    std::vector<Angles> scaled;
+    if (!radians) {
+      scaled.assign(a, angles + end);
+      toRadians(scaled.data(), scaled.size());
+      a = scaled.data();
+    }
+    toBinaryRecords(sequence, a, end - begin, convention, out + begin);
+  });
+}
+
+/**
+ * @brief Converts binary angle records from a file (- for standard input) into binary output
+ * records written to a file (- for standard output)
+ *
+ * @details Regular input files are memory-mapped; when the output is a file too, records are
+ * converted straight into a mapped output file of the final size. Other inputs are read in blocks.
+ * The number of records converted is stored in converted.
+ *
+ * @return 0 on success, -1 if a file cannot be opened or written or the input is not a whole
+ * number of records
+ */
+int convertBinary(const std::string& input, const std::string& output, Sequence sequence,
+                  Convention convention, bool radians, ThreadPool& pool, std::size_t& converted) {
+  converted = 0;
+  const std::size_t batch_size = STREAM_BATCH_SIZE * pool.size();
+  std::vector<BinaryRecord> records(batch_size);
+
+  MappedFile mapped_input;
+  if (input != "-" && mapped_input.openRead(input)) {
+    if (mapped_input.size() % BINARY_ANGLES_SIZE != 0) {
+      std::cerr << "Error: Size of input file " << input << " is not a multiple of "
+                << BINARY_ANGLES_SIZE << " bytes." << std::endl;
+      return -1;
+    }
+    const auto angles = reinterpret_cast<const Angles*>(mapped_input.data());
+    const std::size_t count = mapped_input.size() / BINARY_ANGLES_SIZE;
+
+    if (output != "-") {
+      MappedFile mapped_output;
+      if (!mapped_output.create(output, count * BINARY_RECORD_SIZE)) {
+        std::cerr << "Error: Cannot create output file " << output << "." << std::endl;
+        return -1;
+      }
+      const auto out = reinterpret_cast<BinaryRecord*>(mapped_output.data());
+      convertBlock(sequence, convention, radians, angles, count, out, pool);
+      converted = count;
+      return mapped_output.sync() ? 0 : writeError(output);
+    }
+    for (std::size_t begin = 0; begin < count; begin += batch_size) {
+      const std::size_t n = std::min(batch_size, count - begin);
+      convertBlock(sequence, convention, radians, angles + begin, n, records.data(), pool);
+      if (tracedWrite(records.data(), BINARY_RECORD_SIZE, n, stdout) != n) {
+        break;
+      }
+      converted += n;
+    }
+    return closeOutput(stdout) ? 0 : writeError(output);
+  }
+
+  // Pipes and other files that cannot be mapped are read in blocks
+  std::FILE* in = input == "-" ? stdin : std::fopen(input.c_str(), "rb");
+  if (in == nullptr) {
+    std::cerr << "Error: Cannot open input file " << input << "." << std::endl;
+    return -1;
+  }
+  std::FILE* out = output == "-" ? stdout : std::fopen(output.c_str(), "wb");
+  if (out == nullptr) {
+    std::cerr << "Error: Cannot create output file " << output << "." << std::endl;
+    if (in != stdin) {
+      std::fclose(in);
+    }
+    return -1;
+  }
+
+  std::vector<Angles> angles(batch_size);
+  int status = 0;
+  for (bool end_of_input = false; !end_of_input;) {
+    const std::size_t size = BINARY_ANGLES_SIZE * angles.size();
+    const std::size_t bytes = tracedRead(angles.data(), 1, size, in);
+    end_of_input = bytes < size;
+
+    const std::size_t n = bytes / BINARY_ANGLES_SIZE;
+    convertBlock(sequence, convention, radians, angles.data(), n, records.data(), pool);
+    if (tracedWrite(records.data(), BINARY_RECORD_SIZE, n, out) != n) {
+      break;
+    }
+    converted += n;
+    if (bytes % BINARY_ANGLES_SIZE != 0) {
+      std::cerr << "Error: Input is not a whole number of " << BINARY_ANGLES_SIZE
+                << "-byte records." << std::endl;
+      status = -1;
+    }
+  }
+
+  if (in != stdin) {
+    std::fclose(in);
+  }
+  return closeOutput(out) ? status : writeError(output);
+}
+
+/**
+ * @brief Converts the angles of a memory-mapped .npy file of shape (N, 3)
+ *
+ * @details Rotation matrices are written to a .npy file of shape (N, 3, 3) if matrices is not
+ * empty, and quaternions to a .npy file of shape (N, 4) if quaternions is not empty; both are
+ * mapped and converted into directly. With neither, one line per result is written to standard
+ * output as for text input. The number of records converted is stored in converted.
+ *
+ * @return 0 on success, -1 if a file cannot be read, created or written
+ */
+int convertNpy(const std::string& input, const std::string& matrices,
+               const std::string& quaternions, Sequence sequence, Convention convention,
+               bool radians, ThreadPool& pool, std::size_t& converted) {
+  converted = 0;
+  NpyArray array;
+  NpyError error = array.openRead(input);
+  if (error == NpyError::NONE) {
+    error = checkAngles(array);
+  }
+  if (error != NpyError::NONE) {
+    std::cerr << "Error: Cannot read angles from " << input
+              << ", must be a float32 or float64 .npy file of shape (N, 3)." << std::endl;
+    return -1;
+  }
+
+  const std::size_t count = array.shape()[0];
+  if (matrices.empty() && quaternions.empty()) {
+    const std::size_t batch_size = STREAM_BATCH_SIZE * pool.size();
+    std::vector<Angles> angles(batch_size);
+    std::vector<std::vector<char>> output;
+    for (std::size_t begin = 0; begin < count; begin += batch_size) {
+      const std::size_t n = std::min(batch_size, count - begin);
+      readAngles(array, begin, n, angles.data());
+      if (!radians) {
+        toRadians(angles.data(), n);
+      }
+      if (!writeBatch(stdout, sequence, convention, angles.data(), n, pool, output)) {
+        break;
+      }
+      converted += n;
+    }
+    return closeOutput(stdout) ? 0 : writeError("-");
+  }
+
+  NpyArray R, q;
+  if (!matrices.empty() && R.create(matrices, {count, 3, 3}) != NpyError::NONE) {
+    std::cerr << "Error: Cannot create output file " << matrices << "." << std::endl;
+    return -1;
+  }
+  if (!quaternions.empty() && q.create(quaternions, {count, 4}) != NpyError::NONE) {
+    std::cerr << "Error: Cannot create output file " << quaternions << "." << std::endl;
+    return -1;
+  }
+
+  // Float64 angles in radians are used in place; all others are copied a chunk at a time
+  const Angles* mapped = radians ? anglesData(array) : nullptr;
+  pool.parallelFor(count, PARALLEL_CHUNK_SIZE, [&](std::size_t begin, std::size_t end) {
+    const std::size_t n = end - begin;
+    const Angles* a = mapped + begin;
+    std::vector<Angles> angles;
+    if (mapped == nullptr) {
+      angles.resize(n);
+      readAngles(array, begin, n, angles.data());
+      if (!radians) {
+        toRadians(angles.data(), n);
+      }
+      a = angles.data();
+    }
+    if (!matrices.empty()) {
+      const auto out = reinterpret_cast<RotationMatrix*>(R.data()) + begin;
+      toRotationMatrix(sequence, a, n, convention, out);
+    }
+    if (!quaternions.empty()) {
+      const auto out = reinterpret_cast<Quaternion*>(q.data()) + begin;
+      toQuaternion(sequence, a, n, convention, out);
+    }
+  });
+  converted = count;
+  if (!R.sync()) {
+    return writeError(matrices);
+  }
+  return q.sync() ? 0 : writeError(quaternions);
+}
+
+/// Number of slots of the ring created with --shm
+const std::size_t SHM_CAPACITY = 1024;
+
+/// Server stopped by SIGINT and SIGTERM in --serve mode
+Server* running_server = nullptr;
+
+void stopServer(int) {
+  if (running_server != nullptr) {
+    running_server->stop();
+  }
+}
+
+/// Ring whose worker is stopped by SIGINT and SIGTERM in --shm mode
+SharedRing* running_ring = nullptr;
+
+void stopRing(int) {
+  if (running_ring != nullptr) {
+    running_ring->stop();
+  }
+}
+
+/**
+ * @brief Prints the totals of the probes and the number of records converted per second of elapsed
+ * time to standard error, in the shape of the table of stages of the pipeline
+ *
+ * @details Probe times are summed over threads.
+ */
+void printProbes(std::size_t records, double seconds) {
+  std::cerr << std::fixed << std::setprecision(3);
+  if (EULER_INSTRUMENTATION) {
+    std::cerr << std::left << std::setw(18) << "probe" << std::right << std::setw(10) << "calls"
+              << std::setw(12) << "records" << std::setw(10) << "busy [s]" << std::setw(16)
+              << "records/s" << "\n";
+    for (std::size_t i = 0; i < PROBE_COUNT; ++i) {
+      const auto probe = static_cast<Probe>(i);
+      const ProbeTotals totals = probeTotals(probe);
+      const double busy = totals.nanoseconds * 1e-9;
+      std::cerr << std::left << std::setw(18) << probeName(probe) << std::right << std::setw(10)
+                << totals.calls << std::setw(12) << totals.records << std::setw(10) << busy
+                << std::setprecision(0) << std::setw(16);
+      if (totals.records > 0 && busy > 0) {
+        std::cerr << totals.records / busy;
+      } else {
+        std::cerr << "-";
+      }
+      std::cerr << std::setprecision(3) << "\n";
+    }
+  } else {
+    std::cerr << "probes: compiled out (EULER_INSTRUMENTATION=0)\n";
+  }
+
+  std::cerr << "total: " << records << " records in " << seconds << " s (";
+  if (seconds > 0) {
+    std::cerr << std::setprecision(0) << records / seconds;
+  } else {
+    std::cerr << "-";
+  }
+  std::cerr << " records/s)\n";
+}
+
+/**
+ * @brief Prints the number of allocations and the peak resident set size to standard error
+ */
+void printMemory() {
+  if (EULER_COUNT_ALLOCATIONS) {
+    const AllocationTotals allocations = countedAllocations();
+    std::cerr << std::fixed << "allocations: " << allocations.count << " ("
+              << std::setprecision(1) << allocations.bytes / 1e6 << " MB)\n";
+  } else {
+    std::cerr << "allocations: compiled out (EULER_INSTRUMENTATION=0)\n";
+  }
+
+  rusage usage;
+  if (::getrusage(RUSAGE_SELF, &usage) == 0) {
+    // Linux reports the maximum resident set size in kilobytes
+    std::cerr << "peak RSS: " << std::setprecision(1) << usage.ru_maxrss / 1e3 << " MB\n";
+  }
+  std::cerr << std::flush;
+}
+
+/**
+ * @brief Parses the --threads option
+ *
+ * @return Number of threads (0 for one per core), or -1 if the option is not a valid number
+ */
+int threadCount(const argagg::parser_results& args) {
+  try {
+    const int threads = args["threads"] ? args["threads"].as<int>() : 0;
+    return threads < 0 ? -1 : threads;
+  } catch (const std::exception& e) {
+    return -1;
+  }
+}
+
+/**
+ * @brief Determines if a path names a .npy file
+ */
+bool isNpy(const std::string& path) {
+  return path.size() >= 4 && path.compare(path.size() - 4, 4, ".npy") == 0;
+}
+
+}  // namespace
+
 int main(int argc, char* argv[]) {
   // Create the parser
   // clang-format off
@@ -43,6 +461,67 @@ int main(int argc, char* argv[]) {
       "The rotation sequence (possible values: xyz, xzy, yxz, yzx, zxy, zyx,\n\t"
       "xyx, xzx, yxy, yzy, zxz, zyz; default: zyx)", 
       1
+    },
+    {
+      "input",
+      {"-i", "--input"},
+      "Read three angles per line from a file (- for standard input) and write one\n\t"
+      "line per result: the rotation matrix in row-major order, then the quaternion",
+      1
+    },
+    {
+      "output",
+      {"-o", "--output"},
+      "Write the results of --input to a file rather than standard output (for .npy\n\t"
+      "input, a .npy file of rotation matrices of shape (N, 3, 3))",
+      1
+    },
+    {
+      "quaternions",
+      {"-q", "--quaternions"},
+      "Write the quaternions of .npy input to a .npy file of shape (N, 4)",
+      1
+    },
+    {
+      "binary",
+      {"-b", "--binary"},
+      "Read and write binary records with --input: three float64 angles in, and the\n\t"
+      "nine float64 matrix elements then the four of the quaternion out",
+      0
+    },
+    {
+      "threads",
+      {"-t", "--threads"},
+      "Number of threads converting --input (default: one per core)",
+      1
+    },
+    {
+      "serve",
+      {"--serve"},
+      "Stay resident and answer conversion requests on a Unix domain socket at the\n\t"
+      "given path (see euler/server.h for the protocol)",
+      1
+    },
+    {
+      "shm",
+      {"--shm"},
+      "Stay resident and convert requests written to a ring in shared memory, created\n\t"
+      "at the given path (see euler/shm.h)",
+      1
+    },
+    {
+      "trace",
+      {"--trace"},
+      "Write a timeline of the stages, chunks and threads of --input to a JSON file\n\t"
+      "for chrome://tracing or Perfetto",
+      1
+    },
+    {
+      "stats",
+      {"--stats"},
+      "Print records/s, the time spent parsing, converting and formatting, the\n\t"
+      "allocations and the peak memory use of --input to standard error at exit",
+      0
     }
   }};
   // clang-format on
@@ -51,20 +530,32 @@ int main(int argc, char* argv[]) {
   std::ostringstream usage;
   // clang-format off
   usage << "Usage: euler [-r | --radians] [-e | --extrinsic] [-p | --passive]\n"
-        << std::setw(57) << std::right
-        << "[-s S | --sequence=S] -- ANGLE ANGLE ANGLE\n\n";
+        << std::setw(56) << std::right
+        << "[-s S | --sequence=S] -- ANGLE ANGLE ANGLE\n"
+        << "       euler [-r | --radians] [-e | --extrinsic] [-p | --passive]\n"
+        << std::setw(75) << std::right
+        << "[-s S | --sequence=S] [-b] [-t N] -i FILE [-o FILE] [-q FILE]\n"
+        << "       euler [-t N] --serve SOCKET\n"
+        << "       euler --shm FILE\n\n";
 
   usage << "Calculates rotation matrix and quaternion for given Euler angle sequence.\n"
            "The rotation matrix pre-multiplies vectors in a right-handed coordinate frame.\n"
            "By default the sequence of angles are intepreted to be in degrees and are applied\n"
-           "in intrinsic order using the zyx sequence.\n\n";
+           "in intrinsic order using the zyx sequence. With --input, angles are read three\n"
+           "per line and each result is written on one line, or read and written as binary\n"
+           "records with --binary. Input files ending in .npy hold an array of angles of\n"
+           "shape (N, 3). With --serve, requests are answered over a Unix domain socket,\n"
+           "and with --shm through a ring in shared memory.\n\n";
 
   usage << "Examples:\n"
            "    euler -- 20 -10 35\n"
            "    euler -ep -- 11.1 23.9 -129.4\n"
            "    euler -e -s yzy -- 41.2 -55.5 -97.8\n"
            "    euler -p -s zxy -- -176.234 -0.231 44.399\n"
-           "    euler -rpe -s xzx -- 0.21 1.16 -2.81\n\n";
+           "    euler -rpe -s xzx -- 0.21 1.16 -2.81\n"
+           "    euler -e -s zxz -i angles.txt\n"
+           "    euler -r -b -i angles.bin -o rotations.bin\n"
+           "    euler -t 8 -i angles.npy -o matrices.npy -q quaternions.npy\n\n";
   // clang-format on
 
   // Parse the arguments
@@ -82,6 +573,60 @@ int main(int argc, char* argv[]) {
     return 0;
   }
 
+  // Convert requests, which carry their own sequence and convention, until interrupted
+  if (args["shm"]) {
+    if (args.count() != 0 || args["input"] || args["serve"]) {
+      std::cerr << "Error: Cannot provide angles, --input or --serve with --shm.\n\n"
+                << usage.str() << arg_parser << std::endl;
+      return -1;
+    }
+    SharedRing ring;
+    const auto path = args["shm"].as<std::string>();
+    if (!ring.create(path, SHM_CAPACITY)) {
+      std::cerr << "Error: Cannot create shared-memory ring " << path
+                << "; it must be a new path or a ring left behind by another worker." << std::endl;
+      return -1;
+    }
+    running_ring = &ring;
+    std::signal(SIGINT, stopRing);
+    std::signal(SIGTERM, stopRing);
+    ring.run();
+    running_ring = nullptr;
+    ring.close();
+    std::remove(path.c_str());
+    return 0;
+  }
+
+  // Answer requests, which carry their own sequence and convention, until interrupted
+  if (args["serve"]) {
+    if (args.count() != 0 || args["input"]) {
+      std::cerr << "Error: Cannot provide angles or --input with --serve.\n\n"
+                << usage.str() << arg_parser << std::endl;
+      return -1;
+    }
+    const int threads = threadCount(args);
+    if (threads < 0) {
+      std::cerr << "Error: Invalid number of threads.\n\n"
+                << usage.str() << arg_parser << std::endl;
+      return -1;
+    }
+    ThreadPool pool(threads);
+    Server server(pool);
+    const auto path = args["serve"].as<std::string>();
+    if (!server.listen(path)) {
+      std::cerr << "Error: Cannot listen on socket " << path
+                << "; it must be a new path or the socket of a server that is no longer running."
+                << std::endl;
+      return -1;
+    }
+    running_server = &server;
+    std::signal(SIGINT, stopServer);
+    std::signal(SIGTERM, stopServer);
+    server.run();
+    running_server = nullptr;
+    return 0;
+  }
+
   // Get radians / degrees
   const bool radians = args["radians"];
 
@@ -92,25 +637,133 @@ int main(int argc, char* argv[]) {
   const auto direction = args["passive"] ? Direction::PASSIVE : Direction::ACTIVE;
 
   // Get sequence
-  const auto sequence = args["sequence"].as<std::string>("zyx");
+  const Sequence sequence = args["sequence"].as<std::string>("zyx");
   if (!isSequenceValid(sequence)) {
     std::cerr << "Error: Invalid sequence.\n\n" << usage.str() << arg_parser << std::endl;
     return -1;
   }
 
+  // Stream angles from a file or standard input
+  if (args["input"]) {
+    if (args.count() != 0) {
+      std::cerr << "Error: Cannot provide angles with --input.\n\n"
+                << usage.str() << arg_parser << std::endl;
+      return -1;
+    }
+
+    const int threads = threadCount(args);
+    if (threads < 0) {
+      std::cerr << "Error: Invalid number of threads.\n\n"
+                << usage.str() << arg_parser << std::endl;
+      return -1;
+    }
+    // Tracing starts before the pool, so that its threads are named in the trace
+    if (args["trace"]) {
+      if (!EULER_INSTRUMENTATION) {
+        std::cerr << "Warning: The trace is empty, since instrumentation is compiled out."
+                  << std::endl;
+      }
+      setTraceThreadName("main");
+      startTrace();
+    }
+    ThreadPool pool(threads);
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto path = args["input"].as<std::string>();
+    const auto output = args["output"].as<std::string>("-");
+    const auto quaternions = args["quaternions"].as<std::string>("");
+    // Outputs are truncated when created, which would destroy the input while it is being read
+    for (const std::string* target : {&output, &quaternions}) {
+      if (sameFile(path, *target)) {
+        std::cerr << "Error: Output file " << *target << " is the input file." << std::endl;
+        return -1;
+      }
+    }
+    int status;
+    bool text = false;
+    std::size_t converted = 0;
+    if (isNpy(path)) {
+      if (args["binary"]) {
+        std::cerr << "Error: Cannot use --binary with .npy input.\n\n"
+                  << usage.str() << arg_parser << std::endl;
+        return -1;
+      }
+      status = convertNpy(path, args["output"].as<std::string>(""), quaternions, sequence,
+                          {order, direction}, radians, pool, converted);
+    } else if (args["quaternions"]) {
+      std::cerr << "Error: --quaternions requires .npy input.\n\n"
+                << usage.str() << arg_parser << std::endl;
+      return -1;
+    } else if (args["binary"]) {
+      status =
+          convertBinary(path, output, sequence, {order, direction}, radians, pool, converted);
+    } else {
+      std::FILE* in = path == "-" ? stdin : std::fopen(path.c_str(), "rb");
+      if (in == nullptr) {
+        std::cerr << "Error: Cannot open input file " << path << "." << std::endl;
+        return -1;
+      }
+      std::FILE* out = output == "-" ? stdout : std::fopen(output.c_str(), "wb");
+      if (out == nullptr) {
+        std::cerr << "Error: Cannot create output file " << output << "." << std::endl;
+        if (in != stdin) {
+          std::fclose(in);
+        }
+        return -1;
+      }
+      status = runPipeline(in, out, sequence, {order, direction}, radians, pool, args["stats"]);
+      if (in != stdin) {
+        std::fclose(in);
+      }
+      if (!closeOutput(out)) {
+        status = writeError(output);
+      }
+      text = true;
+    }
+
+    if (args["trace"]) {
+      stopTrace();
+      const auto trace = args["trace"].as<std::string>();
+      if (!writeTrace(trace)) {
+        std::cerr << "Error: Cannot write trace file " << trace << "." << std::endl;
+        status = -1;
+      }
+    }
+
+    // The pipeline of text input has already printed its stages, which cover what the probes
+    // measure, and its total
+    if (args["stats"]) {
+      if (!text) {
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        printProbes(converted, std::chrono::duration<double>(elapsed).count());
+      }
+      printMemory();
+    }
+    return status;
+  } else if (args["output"] || args["binary"] || args["quaternions"] || args["threads"] ||
+             args["stats"] || args["trace"]) {
+    std::cerr << "Error: --output, --quaternions, --binary, --threads, --stats and --trace "
+                 "require --input.\n\n"
+              << usage.str() << arg_parser << std::endl;
+    return -1;
+  }
+
   // Get angles
   if (args.count() != 3) {
     std::cerr << "Error: Must provide exactly three angles.\n\n"
               << usage.str() << arg_parser << std::endl;
     return -1;
   }
+  // Each argument must be one whole number, so that e.g. "1 2" 3 "" is not taken for three
   Angles angles;
-  try {
-    angles = {std::stod(args.pos[0]), std::stod(args.pos[1]), std::stod(args.pos[2])};
-  } catch (const std::invalid_argument&) {
-    std::cerr << "Error: Invalid angles, must be three real numbers.\n\n"
-              << usage.str() << arg_parser << std::endl;
-    return -1;
+  for (std::size_t i = 0; i < 3; ++i) {
+    const char* last = args.pos[i] + std::strlen(args.pos[i]);
+    const ParseResult result = parseDouble(args.pos[i], last, angles[i]);
+    if (result.error != ParseError::NONE || result.ptr != last) {
+      std::cerr << "Error: Invalid angles, must be three real numbers.\n\n"
+                << usage.str() << arg_parser << std::endl;
+      return -1;
+    }
   }
 
   // Convert / verify angles
@@ -126,5 +779,5 @@ int main(int argc, char* argv[]) {
   std::cout << "\nRotation Matrix:\n" << R << "\n";
   std::cout << "\nQuaternion:\n" << q << "\n";
 
-  return 0;
+  return std::cout.flush() ? 0 : writeError("-");
 }
@@ -0,0 +1,314 @@
+#include "pipeline.h"
+
+#include <euler/instrument.h>
+#include <euler/io.h>
+#include <euler/queue.h>
+#include <euler/trace.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace euler {
+namespace {  // anonymous
+
+/// Bytes of text read at a time; a block of lines is at most this long unless a line is longer
+const std::size_t BLOCK_SIZE = 1 << 20;
+
+/// Number of blocks that may wait between two stages
+const std::size_t QUEUE_CAPACITY = 4;
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief A block of consecutive lines on its way through the stages
+ */
+struct Block {
+  std::vector<char> text;                 ///< Complete lines of text (read)
+  std::vector<Angles> angles;             ///< Angles in radians (parse)
+  std::size_t count = 0;                  ///< Number of sets of angles (parse)
+  std::size_t error_line = 0;             ///< Line number of an invalid line, 0 if none (parse)
+  std::vector<RotationMatrix> R;          ///< Rotation matrices (compute)
+  std::vector<Quaternion> q;              ///< Quaternions (compute)
+  std::vector<std::vector<char>> output;  ///< Lines of results, one buffer per chunk (format)
+  std::vector<std::size_t> sizes;         ///< Number of characters in each buffer (format)
+};
+
+using Queue = SpscQueue<std::unique_ptr<Block>>;
+
+/**
+ * @brief Work done by one stage, excluding the time spent waiting on its queues
+ */
+struct Stage {
+  const char* name;
+  double seconds = 0;
+  std::size_t records = 0;
+  std::size_t bytes = 0;
+
+  explicit Stage(const char* name) : name(name) {}
+
+  /// Adds the work on one block, which started at start, and records it in the trace
+  void add(Clock::time_point start) {
+    const auto end = Clock::now();
+    seconds += std::chrono::duration<double>(end - start).count();
+    traceEvent(name, "stage", start, end, 0);
+  }
+};
+
+void readBlocks(std::FILE* in, Queue& out, Stage& stage) {
+  setTraceThreadName(stage.name);
+  std::vector<char> carry;
+  for (bool end_of_input = false; !end_of_input;) {
+    const auto start = Clock::now();
+    std::unique_ptr<Block> block(new Block);
+    std::vector<char>& text = block->text;
+    text.swap(carry);
+    std::size_t size = text.size();
+
+    // Read until the block holds at least one complete line, growing it for very long lines
+    std::size_t complete = 0;
+    while (complete == 0 && !end_of_input) {
+      text.resize(std::max(BLOCK_SIZE, 2 * size));
+      size += std::fread(text.data() + size, 1, text.size() - size, in);
+      end_of_input = size < text.size();
+      complete = size;
+      while (!end_of_input && complete != 0 && text[complete - 1] != '\n') {
+        --complete;
+      }
+    }
+
+    // Keep the incomplete last line for the next block
+    carry.assign(text.begin() + complete, text.begin() + size);
+    text.resize(complete);
+    stage.bytes += complete;
+    stage.add(start);
+    if (!out.push(std::move(block))) {
+      break;
+    }
+  }
+  out.close();
+}
+
+/**
+ * @brief Parses the lines of a block into its angles, stopping at the first invalid line
+ */
+void parseLines(Block& block, bool radians, std::size_t& line_number) {
+  ProbeTimer timer(Probe::PARSE);
+  const char* p = block.text.data();
+  const char* last = p + block.text.size();
+  while (p != last) {
+    ++line_number;
+    Angles a;
+    const ParseResult result = parseAngles(p, last, a);
+    p = result.ptr;
+    if (result.error == ParseError::EMPTY_LINE) {
+      continue;
+    } else if (result.error != ParseError::NONE) {
+      block.error_line = line_number;
+      break;
+    }
+    if (!radians) {
+      std::for_each(a.begin(), a.end(), [](double& x) { x *= M_PI / 180; });
+    }
+    block.angles.push_back(a);
+  }
+  block.count = block.angles.size();
+  timer.addRecords(block.count);
+}
+
+void parseBlocks(Queue& in, Queue& out, bool radians, Stage& stage) {
+  setTraceThreadName(stage.name);
+  std::size_t line_number = 0;
+  std::unique_ptr<Block> block;
+  while (in.pop(block)) {
+    const auto start = Clock::now();
+    parseLines(*block, radians, line_number);
+    stage.records += block->count;
+    stage.bytes += block->text.size();
+    std::vector<char>().swap(block->text);
+    stage.add(start);
+
+    // Nothing after an invalid line is converted, so reading stops too
+    const bool failed = block->error_line != 0;
+    if (!out.push(std::move(block)) || failed) {
+      in.close();
+      break;
+    }
+  }
+  out.close();
+}
+
+void computeBlocks(Queue& in, Queue& out, Sequence sequence, Convention convention,
+                   ThreadPool& pool, std::mutex& pool_mutex, Stage& stage) {
+  setTraceThreadName(stage.name);
+  std::unique_ptr<Block> block;
+  while (in.pop(block)) {
+    std::unique_lock<std::mutex> lock(pool_mutex);
+    const auto start = Clock::now();
+    const std::size_t n = block->angles.size();
+    block->R.resize(n);
+    block->q.resize(n);
+    toRotationMatrix(sequence, block->angles.data(), n, convention, block->R.data(), pool);
+    toQuaternion(sequence, block->angles.data(), n, convention, block->q.data(), pool);
+    lock.unlock();
+    std::vector<Angles>().swap(block->angles);
+    stage.records += n;
+    stage.add(start);
+    if (!out.push(std::move(block))) {
+      in.close();
+      break;
+    }
+  }
+  out.close();
+}
+
+void formatBlocks(Queue& in, Queue& out, ThreadPool& pool, std::mutex& pool_mutex, Stage& stage) {
+  setTraceThreadName(stage.name);
+  std::unique_ptr<Block> block;
+  while (in.pop(block)) {
+    std::unique_lock<std::mutex> lock(pool_mutex);
+    const auto start = Clock::now();
+    const std::size_t n = block->R.size();
+    const std::size_t chunks = (n + PARALLEL_CHUNK_SIZE - 1) / PARALLEL_CHUNK_SIZE;
+    block->output.resize(chunks);
+    block->sizes.resize(chunks);
+    pool.parallelFor(n, PARALLEL_CHUNK_SIZE, [&](std::size_t begin, std::size_t end) {
+      const std::size_t c = begin / PARALLEL_CHUNK_SIZE;
+      block->sizes[c] =
+          formatLines(&block->R[begin], &block->q[begin], end - begin, block->output[c]);
+    });
+    lock.unlock();
+    std::vector<RotationMatrix>().swap(block->R);
+    std::vector<Quaternion>().swap(block->q);
+    stage.records += n;
+    for (const auto size : block->sizes) {
+      stage.bytes += size;
+    }
+    stage.add(start);
+    if (!out.push(std::move(block))) {
+      in.close();
+      break;
+    }
+  }
+  out.close();
+}
+
+int writeBlocks(Queue& in, std::FILE* out, Stage& stage) {
+  std::unique_ptr<Block> block;
+  while (in.pop(block)) {
+    const auto start = Clock::now();
+    for (std::size_t c = 0; c < block->output.size(); ++c) {
+      if (std::fwrite(block->output[c].data(), 1, block->sizes[c], out) != block->sizes[c]) {
+        // The caller finds the error on the file and reports it
+        in.close();
+        return -1;
+      }
+      stage.bytes += block->sizes[c];
+    }
+    stage.records += block->count;
+    stage.add(start);
+
+    if (block->error_line != 0) {
+      std::fflush(out);
+      std::cerr << "Error: Invalid angles on line " << block->error_line
+                << ", must be three real numbers." << std::endl;
+      in.close();
+      return -1;
+    }
+  }
+  std::fflush(out);
+  return 0;
+}
+
+void report(const std::vector<const Stage*>& stages, double seconds) {
+  std::cerr << std::fixed << std::setprecision(3) << std::left << std::setw(10) << "stage"
+            << std::right << std::setw(10) << "busy [s]" << std::setw(16) << "records/s"
+            << std::setw(12) << "MB/s" << "\n";
+  for (const auto stage : stages) {
+    std::cerr << std::left << std::setw(10) << stage->name << std::right << std::setw(10)
+              << stage->seconds << std::setprecision(0) << std::setw(16);
+    if (stage->records > 0 && stage->seconds > 0) {
+      std::cerr << stage->records / stage->seconds;
+    } else {
+      std::cerr << "-";
+    }
+    std::cerr << std::setprecision(1) << std::setw(12);
+    if (stage->bytes > 0 && stage->seconds > 0) {
+      std::cerr << stage->bytes / stage->seconds / 1e6;
+    } else {
+      std::cerr << "-";
+    }
+    std::cerr << std::setprecision(3) << "\n";
+  }
+  const std::size_t records = stages[1]->records;
+  std::cerr << "total: " << records << " records in " << seconds << " s (";
+  if (seconds > 0) {
+    std::cerr << std::setprecision(0) << records / seconds;
+  } else {
+    std::cerr << "-";
+  }
+  std::cerr << " records/s)" << std::endl;
+}
+
+}  // namespace
+
+std::size_t formatLines(const RotationMatrix* R, const Quaternion* q, std::size_t count,
+                        std::vector<char>& output) {
+  const ProbeTimer timer(Probe::FORMAT, count);
+
+  // Elements of rotations are at most one in magnitude, so lines are short and the buffer rarely
+  // needs to grow
+  std::size_t size = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    if (output.size() < size + 2 * MAX_FORMAT_LENGTH + 2) {
+      output.resize(2 * (size + MAX_FORMAT_LENGTH + 1));
+    }
+    char* p = formatCompact(output.data() + size, R[i]);
+    *p++ = ' ';
+    p = formatCompact(p, q[i]);
+    *p++ = '\n';
+    size = p - output.data();
+  }
+  return size;
+}
+
+int runPipeline(std::FILE* in, std::FILE* out, Sequence sequence, Convention convention,
+                bool radians, ThreadPool& pool, bool stats) {
+  const auto start = Clock::now();
+
+  // Conversion and formatting take turns on the pool, each spreading a block over all its threads
+  std::mutex pool_mutex;
+
+  Queue read_queue(QUEUE_CAPACITY), parse_queue(QUEUE_CAPACITY), compute_queue(QUEUE_CAPACITY),
+      format_queue(QUEUE_CAPACITY);
+  Stage read_stage("read"), parse_stage("parse"), compute_stage("compute"),
+      format_stage("format"), write_stage("write");
+
+  std::vector<std::thread> threads;
+  threads.emplace_back(readBlocks, in, std::ref(read_queue), std::ref(read_stage));
+  threads.emplace_back(parseBlocks, std::ref(read_queue), std::ref(parse_queue), radians,
+                       std::ref(parse_stage));
+  threads.emplace_back(computeBlocks, std::ref(parse_queue), std::ref(compute_queue),
+                       sequence, convention, std::ref(pool), std::ref(pool_mutex),
+                       std::ref(compute_stage));
+  threads.emplace_back(formatBlocks, std::ref(compute_queue), std::ref(format_queue),
+                       std::ref(pool), std::ref(pool_mutex), std::ref(format_stage));
+  const int status = writeBlocks(format_queue, out, write_stage);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  if (stats) {
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    report({&read_stage, &parse_stage, &compute_stage, &format_stage, &write_stage}, seconds);
+  }
+  return status;
+}
+
+}  // namespace euler
@@ -0,0 +1,51 @@
+#ifndef EULER_APPS_PIPELINE_H
+#define EULER_APPS_PIPELINE_H
+
+#include <euler/parallel.h>
+#include <euler/rotations.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+namespace euler {
+
+/**
+ * @brief Formats results one per line: the rotation matrix in row-major order, then the quaternion
+ *
+ * @param[in] R Pointer to the first of count rotation matrices
+ * @param[in] q Pointer to the first of count quaternions
+ * @param[in] count Number of results
+ * @param[in,out] output Buffer for the lines, grown as needed
+ *
+ * @return Number of characters written to output
+ */
+std::size_t formatLines(const RotationMatrix* R, const Quaternion* q, std::size_t count,
+                        std::vector<char>& output);
+
+/**
+ * @brief Converts three angles per line of text into one result per line
+ *
+ * @details Reading, parsing, conversion, formatting and writing run as five stages on their own
+ * threads, connected by bounded lock-free queues of blocks of lines, so that input, computation and
+ * output overlap. Conversion and formatting take turns spreading each block over all the threads
+ * of pool, so with a pool of N threads the pipeline runs N - 1 + 4 threads besides the caller,
+ * which writes. Stages waiting on their queues sleep. Results are written in input order.
+ *
+ * @param[in] in File to read
+ * @param[in] out File to write
+ * @param[in] sequence Rotation sequence of all angles
+ * @param[in] convention Rotation convention of all angles
+ * @param[in] radians True if the angles are in radians rather than degrees
+ * @param[in] pool Threads for conversion and formatting
+ * @param[in] stats True to print the throughput of every stage to standard error
+ *
+ * @return 0 on success, -1 if a line does not hold exactly three real numbers or out cannot be
+ * written (the latter is left to the caller to report, from the error indicator of out)
+ */
+int runPipeline(std::FILE* in, std::FILE* out, Sequence sequence, Convention convention,
+                bool radians, ThreadPool& pool, bool stats);
+
+}  // namespace euler
+
+#endif
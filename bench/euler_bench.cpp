@@ -0,0 +1,520 @@
+#include <euler/io.h>
+#include <euler/parallel.h>
+#include <euler/rotations.h>
+
+#include "allocations.h"
+#include "perf_counters.h"
+#include "pipeline.h"
+
+#include <argagg/argagg.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace euler;
+
+namespace {  // anonymous
+
+using Clock = std::chrono::steady_clock;
+
+/// Number of sets of angles in the batches, and cycled through by the single conversions
+const std::size_t BATCH_SIZE = 1024;
+
+/// Number of lines of the text converted by the end-to-end benchmark of the pipeline
+const std::size_t PIPELINE_LINES = 100000;
+
+/**
+ * @brief Keeps the compiler from optimizing away the computation of a value
+ */
+template <typename T>
+inline void doNotOptimize(const T& value) {
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+/**
+ * @brief A function to measure
+ *
+ * @details run(n) performs n operations, each processing records sets of angles, rotations or
+ * lines of text and bytes bytes of input. Times and allocations are reported per record.
+ */
+struct Benchmark {
+  std::string name;
+  std::size_t records;
+  std::size_t bytes;
+  std::function<void(std::size_t)> run;
+};
+
+/**
+ * @brief Measurements of one benchmark
+ */
+struct Result {
+  double ns_per_record;
+  double allocations_per_record;
+  double bytes_allocated_per_record;
+  double events_per_record[PERF_EVENT_COUNT];  ///< NaN for events that are not counted
+};
+
+/**
+ * @brief Runs a benchmark for at least min_seconds, repetitions times, keeping the fastest run
+ *
+ * @details The number of operations is grown until one run lasts min_seconds, so the cost of
+ * reading the clock is negligible. The fastest repetition is the least disturbed by the rest of the
+ * system, and its hardware events and allocations are reported with it.
+ */
+Result measure(const Benchmark& benchmark, double min_seconds, int repetitions,
+               PerfCounters& counters) {
+  benchmark.run(1);
+
+  std::size_t operations = 1;
+  Result best = {HUGE_VAL, 0, 0, {NAN, NAN, NAN, NAN}};
+  for (int repetition = 0; repetition < repetitions;) {
+    const AllocationTotals allocations = countedAllocations();
+    counters.start();
+    const auto start = Clock::now();
+    benchmark.run(operations);
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    counters.stop();
+    const AllocationTotals end = countedAllocations();
+
+    if (seconds < min_seconds) {
+      const double growth = seconds > 0 ? 1.4 * min_seconds / seconds : 100;
+      operations *= static_cast<std::size_t>(std::max(2.0, std::min(100.0, growth)));
+      continue;
+    }
+    const double records = static_cast<double>(operations) * benchmark.records;
+    if (seconds * 1e9 / records < best.ns_per_record) {
+      best.ns_per_record = seconds * 1e9 / records;
+      for (std::size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+        best.events_per_record[i] = counters.count(static_cast<PerfEvent>(i)) / records;
+      }
+      best.allocations_per_record = (end.count - allocations.count) / records;
+      best.bytes_allocated_per_record = (end.bytes - allocations.bytes) / records;
+    }
+    ++repetition;
+  }
+  return best;
+}
+
+/**
+ * @brief Reads results written with --csv, by name
+ *
+ * @return False if the file cannot be read
+ */
+bool readResults(const std::string& path, std::map<std::string, Result>& results) {
+  std::ifstream file(path);
+  if (!file) {
+    return false;
+  }
+  std::string line;
+  std::getline(file, line);  // header
+  while (std::getline(file, line)) {
+    std::istringstream fields(line);
+    std::string name;
+    Result result;
+    char comma;
+    if (std::getline(fields, name, ',') && fields >> result.ns_per_record >> comma >>
+                                               result.allocations_per_record >> comma >>
+                                               result.bytes_allocated_per_record) {
+      results[name] = result;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Prints a number of events in a column, or - if they were not counted
+ */
+void printEvents(std::ostream& os, double value, int width, int precision) {
+  if (std::isnan(value)) {
+    os << std::setw(width) << "-";
+  } else {
+    os << std::setprecision(precision) << std::setw(width) << value;
+  }
+}
+
+std::vector<Angles> randomAngles(std::size_t count) {
+  std::mt19937_64 generator(42);
+  std::uniform_real_distribution<double> distribution(-M_PI, M_PI);
+  std::vector<Angles> angles(count);
+  for (auto& a : angles) {
+    a = {distribution(generator), distribution(generator), distribution(generator)};
+  }
+  return angles;
+}
+
+/**
+ * @brief Lists the benchmarks of every public conversion and of the CLI paths
+ *
+ * @details The benchmarks refer to angles, which must outlive them.
+ */
+std::vector<Benchmark> benchmarks(const std::vector<Angles>& angles, const std::string& text) {
+  const std::size_t n = angles.size();
+  const Angles* a = angles.data();
+  std::vector<Benchmark> list;
+
+  const char* sequences[] = {"xyz", "xzy", "yxz", "yzx", "zxy", "zyx",
+                             "xyx", "xzx", "yxy", "yzy", "zxz", "zyz"};
+  const std::pair<const char*, Convention> conventions[] = {
+      {"intrinsic-active", {Order::INTRINSIC, Direction::ACTIVE}},
+      {"intrinsic-passive", {Order::INTRINSIC, Direction::PASSIVE}},
+      {"extrinsic-active", {Order::EXTRINSIC, Direction::ACTIVE}},
+      {"extrinsic-passive", {Order::EXTRINSIC, Direction::PASSIVE}}};
+
+  for (const Sequence sequence : sequences) {
+    for (const auto& c : conventions) {
+      const std::string suffix = std::string("/") + sequence.name() + "/" + c.first;
+      const Convention convention = c.second;
+      list.push_back({"toRotationMatrix" + suffix, 1, sizeof(Angles), [=](std::size_t ops) {
+                        for (std::size_t i = 0; i < ops; ++i) {
+                          doNotOptimize(toRotationMatrix(sequence, a[i % n], convention));
+                        }
+                      }});
+      list.push_back({"toRotationMatrix[batch]" + suffix, n, n * sizeof(Angles),
+                      [=](std::size_t ops) {
+                        std::vector<RotationMatrix> R(n);
+                        for (std::size_t i = 0; i < ops; ++i) {
+                          toRotationMatrix(sequence, a, n, convention, R.data());
+                          doNotOptimize(R[0]);
+                        }
+                      }});
+    }
+  }
+
+  const Sequence zyx = "zyx";
+  const Convention convention(Order::INTRINSIC, Direction::ACTIVE);
+  std::vector<RotationMatrix> matrices(n);
+  toRotationMatrix(zyx, a, n, convention, matrices.data());
+  std::vector<Quaternion> quaternions(n);
+  toQuaternion(zyx, a, n, convention, quaternions.data());
+
+  list.push_back({"toQuaternion/zyx", 1, sizeof(Angles), [=](std::size_t ops) {
+                    for (std::size_t i = 0; i < ops; ++i) {
+                      doNotOptimize(toQuaternion(zyx, a[i % n], convention));
+                    }
+                  }});
+  list.push_back({"toQuaternion[batch]/zyx", n, n * sizeof(Angles), [=](std::size_t ops) {
+                    std::vector<Quaternion> q(n);
+                    for (std::size_t i = 0; i < ops; ++i) {
+                      toQuaternion(zyx, a, n, convention, q.data());
+                      doNotOptimize(q[0]);
+                    }
+                  }});
+  list.push_back({"toQuaternion(RotationMatrix)", 1, sizeof(RotationMatrix),
+                  [=](std::size_t ops) {
+                    for (std::size_t i = 0; i < ops; ++i) {
+                      doNotOptimize(toQuaternion(matrices[i % n]));
+                    }
+                  }});
+  list.push_back({"operator*", 1, 2 * sizeof(RotationMatrix), [=](std::size_t ops) {
+                    for (std::size_t i = 0; i < ops; ++i) {
+                      doNotOptimize(matrices[i % n] * matrices[(i + 1) % n]);
+                    }
+                  }});
+  list.push_back({"transpose", 1, sizeof(RotationMatrix), [=](std::size_t ops) {
+                    for (std::size_t i = 0; i < ops; ++i) {
+                      doNotOptimize(transpose(matrices[i % n]));
+                    }
+                  }});
+
+  // Names are parsed from strings as the CLI does, so that the check is not folded at compile time
+  const std::vector<std::string> names = {"zyx", "xzx", "xxy", "zyxz"};
+  list.push_back({"isSequenceValid", 1, 3, [=](std::size_t ops) {
+                    for (std::size_t i = 0; i < ops; ++i) {
+                      const bool valid = isSequenceValid(names[i % names.size()]);
+                      doNotOptimize(valid);
+                    }
+                  }});
+
+  list.push_back({"operator<<(RotationMatrix)", 1, sizeof(RotationMatrix), [=](std::size_t ops) {
+                    std::ostringstream os;
+                    for (std::size_t i = 0; i < ops; ++i) {
+                      os.str("");
+                      os << matrices[i % n];
+                    }
+                    doNotOptimize(os);
+                  }});
+  list.push_back({"operator<<(Quaternion)", 1, sizeof(Quaternion), [=](std::size_t ops) {
+                    std::ostringstream os;
+                    for (std::size_t i = 0; i < ops; ++i) {
+                      os.str("");
+                      os << quaternions[i % n];
+                    }
+                    doNotOptimize(os);
+                  }});
+  list.push_back({"formatLines", n, n * (sizeof(RotationMatrix) + sizeof(Quaternion)),
+                  [=](std::size_t ops) {
+                    std::vector<char> output;
+                    for (std::size_t i = 0; i < ops; ++i) {
+                      doNotOptimize(formatLines(matrices.data(), quaternions.data(), n, output));
+                    }
+                  }});
+
+  // The work of one invocation with angles on the command line, less starting the process
+  list.push_back({"cli/angles", 1, 0, [=](std::size_t ops) {
+                    const std::string line = "20 -10 35";
+                    std::ostringstream os;
+                    for (std::size_t i = 0; i < ops; ++i) {
+                      Angles angles;
+                      parseAngles(line.data(), line.data() + line.size(), angles);
+                      for (auto& x : angles) {
+                        x *= M_PI / 180;
+                      }
+                      const RotationMatrix R = toRotationMatrix(zyx, angles, convention);
+                      const Quaternion q = toQuaternion(R);
+                      os.str("");
+                      os << "\nRotation Matrix:\n" << R << "\n";
+                      os << "\nQuaternion:\n" << q << "\n";
+                    }
+                    doNotOptimize(os);
+                  }});
+
+  // Text through every stage of the pipeline of --input, on one conversion thread
+  const std::size_t lines = PIPELINE_LINES;
+  list.push_back({"cli/text-pipeline", lines, text.size(), [=](std::size_t ops) {
+                    std::FILE* in = std::tmpfile();
+                    std::FILE* out = std::fopen("/dev/null", "wb");
+                    std::fwrite(text.data(), 1, text.size(), in);
+                    ThreadPool pool(1);
+                    for (std::size_t i = 0; i < ops; ++i) {
+                      std::rewind(in);
+                      runPipeline(in, out, zyx, convention, false, pool, false);
+                    }
+                    std::fclose(out);
+                    std::fclose(in);
+                  }});
+  return list;
+}
+
+/**
+ * @brief Text of PIPELINE_LINES lines of three angles in degrees, as read by --input
+ */
+std::string pipelineText() {
+  const auto angles = randomAngles(PIPELINE_LINES);
+  std::string text;
+  char line[96];
+  for (const auto& a : angles) {
+    const int length = std::snprintf(line, sizeof(line), "%.6f %.6f %.6f\n", a[0] * 180 / M_PI,
+                                     a[1] * 180 / M_PI, a[2] * 180 / M_PI);
+    text.append(line, length);
+  }
+  return text;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  // clang-format off
+  argagg::parser arg_parser {{
+    {
+      "help",
+      {"-h", "--help"},
+      "Print help and exit",
+      0
+    },
+    {
+      "filter",
+      {"-f", "--filter"},
+      "Run only the benchmarks whose names contain the given text",
+      1
+    },
+    {
+      "list",
+      {"-l", "--list"},
+      "List the names of the benchmarks and exit",
+      0
+    },
+    {
+      "min_time",
+      {"--min-time"},
+      "Minimum duration of each measured run in seconds (default: 0.1)",
+      1
+    },
+    {
+      "repetitions",
+      {"--repetitions"},
+      "Number of measured runs per benchmark, of which the fastest is reported\n\t"
+      "(default: 3)",
+      1
+    },
+    {
+      "no_counters",
+      {"--no-counters"},
+      "Do not read hardware performance counters",
+      0
+    },
+    {
+      "csv",
+      {"--csv"},
+      "Also write the results to a CSV file, to serve as a baseline later",
+      1
+    },
+    {
+      "baseline",
+      {"--baseline"},
+      "Compare with the results of an earlier --csv run and fail on regressions",
+      1
+    },
+    {
+      "tolerance",
+      {"--tolerance"},
+      "Slowdown in percent over the baseline reported as a regression (default: 10)",
+      1
+    }
+  }};
+  // clang-format on
+
+  std::ostringstream usage;
+  usage << "Usage: euler_bench [-f TEXT] [--min-time S] [--repetitions N] [--no-counters]\n"
+        << "                   [--csv FILE] [--baseline FILE [--tolerance PERCENT]]\n"
+        << "       euler_bench --list\n\n"
+        << "Measures the time and the allocations per record of every public conversion and of\n"
+           "the command-line paths. Records are sets of angles, rotations or lines of text.\n"
+           "Allocations count every call of operator new, on any thread. Where the kernel\n"
+           "allows it, cycles, instructions per cycle, cache misses and branch misses per\n"
+           "record are read from the hardware performance counters too.\n\n";
+
+  argagg::parser_results args;
+  double min_seconds;
+  int repetitions;
+  double tolerance;
+  try {
+    args = arg_parser.parse(argc, argv);
+    min_seconds = args["min_time"] ? args["min_time"].as<double>() : 0.1;
+    repetitions = args["repetitions"] ? args["repetitions"].as<int>() : 3;
+    tolerance = args["tolerance"] ? args["tolerance"].as<double>() : 10;
+  } catch (const std::exception& e) {
+    std::cerr << "Error: Invalid arguments.\n\n" << usage.str() << arg_parser << std::endl;
+    return -1;
+  }
+  if (args["help"]) {
+    std::cerr << usage.str() << arg_parser << std::endl;
+    return 0;
+  }
+  if (min_seconds <= 0 || repetitions < 1 || tolerance < 0 || args.count() != 0) {
+    std::cerr << "Error: Invalid arguments.\n\n" << usage.str() << arg_parser << std::endl;
+    return -1;
+  }
+
+  std::map<std::string, Result> baseline;
+  if (args["baseline"] && !readResults(args["baseline"].as<std::string>(), baseline)) {
+    std::cerr << "Error: Cannot read baseline " << args["baseline"].as<std::string>() << "."
+              << std::endl;
+    return -1;
+  }
+  std::ofstream csv;
+  if (args["csv"]) {
+    csv.open(args["csv"].as<std::string>());
+    if (!csv) {
+      std::cerr << "Error: Cannot create " << args["csv"].as<std::string>() << "." << std::endl;
+      return -1;
+    }
+    csv << "name,ns_per_record,allocations_per_record,bytes_allocated_per_record,"
+           "cycles_per_record,instructions_per_record,cache_misses_per_record,"
+           "branch_misses_per_record\n";
+  }
+
+  const auto filter = args["filter"].as<std::string>("");
+  const auto angles = randomAngles(BATCH_SIZE);
+  const auto list = benchmarks(angles, pipelineText());
+  if (args["list"]) {
+    for (const auto& benchmark : list) {
+      std::cout << benchmark.name << "\n";
+    }
+    return 0;
+  }
+
+#ifndef __OPTIMIZE__
+  std::cerr << "Warning: euler_bench was built without optimization "
+               "(configure with -DCMAKE_BUILD_TYPE=Release)." << std::endl;
+#endif
+
+  // Without counters (e.g. no PMU in a virtual machine), only times and allocations are reported
+  PerfCounters counters;
+  const bool hardware = !args["no_counters"] && counters.anyAvailable();
+  if (!args["no_counters"] && !counters.error().empty()) {
+    std::cerr << "Note: " << (hardware ? "Some" : "No") << " hardware counters are read ("
+              << counters.error() << ")." << std::endl;
+  }
+
+  std::cout << std::left << std::setw(48) << "benchmark" << std::right << std::setw(10)
+            << "ns/op" << std::setw(12) << "Mop/s" << std::setw(10) << "MB/s" << std::setw(12)
+            << "allocs/op" << std::setw(12) << "bytes/op";
+  if (hardware) {
+    std::cout << std::setw(12) << "cycles/op" << std::setw(8) << "IPC" << std::setw(14)
+              << "cache-miss/op" << std::setw(12) << "br-miss/op";
+  }
+  if (!baseline.empty()) {
+    std::cout << std::setw(10) << "change";
+  }
+  std::cout << std::endl;
+
+  int regressions = 0;
+  for (const auto& benchmark : list) {
+    if (benchmark.name.find(filter) == std::string::npos) {
+      continue;
+    }
+    const Result result = measure(benchmark, min_seconds, repetitions, counters);
+    const double* events = result.events_per_record;
+    const double bytes_per_record = static_cast<double>(benchmark.bytes) / benchmark.records;
+
+    std::cout << std::left << std::setw(48) << benchmark.name << std::right << std::fixed
+              << std::setprecision(2) << std::setw(10) << result.ns_per_record << std::setw(12)
+              << 1e3 / result.ns_per_record << std::setprecision(1) << std::setw(10);
+    if (bytes_per_record > 0) {
+      std::cout << 1e3 * bytes_per_record / result.ns_per_record;
+    } else {
+      std::cout << "-";
+    }
+    std::cout << std::setprecision(3) << std::setw(12) << result.allocations_per_record
+              << std::setprecision(1) << std::setw(12) << result.bytes_allocated_per_record;
+    if (hardware) {
+      const double cycles = events[static_cast<std::size_t>(PerfEvent::CYCLES)];
+      const double instructions = events[static_cast<std::size_t>(PerfEvent::INSTRUCTIONS)];
+      printEvents(std::cout, cycles, 12, 1);
+      printEvents(std::cout, instructions / cycles, 8, 2);
+      printEvents(std::cout, events[static_cast<std::size_t>(PerfEvent::CACHE_MISSES)], 14, 3);
+      printEvents(std::cout, events[static_cast<std::size_t>(PerfEvent::BRANCH_MISSES)], 12, 3);
+    }
+
+    const auto base = baseline.find(benchmark.name);
+    if (base != baseline.end()) {
+      // Allocations do not vary with timing, but setup allocations are spread over a varying
+      // number of operations
+      const double change = 100 * (result.ns_per_record / base->second.ns_per_record - 1);
+      const bool regression =
+          change > tolerance ||
+          result.allocations_per_record > base->second.allocations_per_record + 0.01;
+      std::cout << std::setw(9) << std::showpos << change << std::noshowpos << "%"
+                << (regression ? "  REGRESSION" : "");
+      regressions += regression ? 1 : 0;
+    }
+    std::cout << std::endl;
+
+    if (csv) {
+      csv << benchmark.name << "," << std::setprecision(6) << result.ns_per_record << ","
+          << result.allocations_per_record << "," << result.bytes_allocated_per_record;
+      for (std::size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+        csv << ",";
+        if (hardware && !std::isnan(events[i])) {
+          csv << events[i];
+        }
+      }
+      csv << "\n";
+    }
+  }
+
+  if (!baseline.empty()) {
+    std::cout << regressions << " regression(s) against the baseline" << std::endl;
+  }
+  return regressions == 0 ? 0 : 1;
+}
@@ -0,0 +1,137 @@
+#include "perf_counters.h"
+
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace euler {
+namespace {  // anonymous
+
+const char* eventName(std::size_t event) {
+  static const char* names[PERF_EVENT_COUNT] = {"cycles", "instructions", "cache misses",
+                                                "branch misses"};
+  return names[event];
+}
+
+}  // namespace
+
+#ifdef __linux__
+
+PerfCounters::PerfCounters() : leader_(-1) {
+  const std::uint64_t configs[PERF_EVENT_COUNT] = {
+      PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+      PERF_COUNT_HW_BRANCH_MISSES};
+  for (std::size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = configs[i];
+    // Only the leader is disabled; the others count whenever it does
+    attr.disabled = leader_ == -1 ? 1 : 0;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format =
+        PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    fds_[i] = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, leader_, 0));
+    counts_[i] = NAN;
+    if (fds_[i] == -1 && error_.empty()) {
+      error_ = std::string("cannot count ") + eventName(i) + ": " + std::strerror(errno);
+    } else if (leader_ == -1) {
+      leader_ = fds_[i];
+    }
+  }
+}
+
+PerfCounters::~PerfCounters() {
+  for (const int fd : fds_) {
+    if (fd != -1) {
+      ::close(fd);
+    }
+  }
+}
+
+void PerfCounters::start() {
+  if (leader_ != -1) {
+    ::ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ::ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+}
+
+void PerfCounters::stop() {
+  for (auto& count : counts_) {
+    count = NAN;
+  }
+  if (leader_ == -1) {
+    return;
+  }
+  ::ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+  // Number of events, time enabled, time running, then one value per event in the order opened
+  std::uint64_t values[3 + PERF_EVENT_COUNT];
+  const ssize_t size = ::read(leader_, values, sizeof(values));
+  if (size < static_cast<ssize_t>(3 * sizeof(std::uint64_t)) ||
+      size != static_cast<ssize_t>((3 + values[0]) * sizeof(std::uint64_t))) {
+    return;
+  }
+  std::size_t value = 3;
+  for (std::size_t i = 0; i < PERF_EVENT_COUNT && value < size / sizeof(std::uint64_t); ++i) {
+    if (fds_[i] == -1) {
+      continue;
+    }
+    if (values[2] == 0) {
+      counts_[i] = values[1] == 0 ? 0 : NAN;
+    } else {
+      counts_[i] = static_cast<double>(values[value]) * values[1] / values[2];
+    }
+    ++value;
+  }
+}
+
+double PerfCounters::count(PerfEvent event) const {
+  return counts_[static_cast<std::size_t>(event)];
+}
+
+#else
+
+PerfCounters::PerfCounters() : leader_(-1) {
+  for (std::size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+    fds_[i] = -1;
+    counts_[i] = NAN;
+  }
+  error_ = "hardware counters need perf_event_open (Linux)";
+}
+
+PerfCounters::~PerfCounters() {}
+
+void PerfCounters::start() {}
+
+void PerfCounters::stop() {}
+
+double PerfCounters::count(PerfEvent) const { return NAN; }
+
+#endif
+
+bool PerfCounters::available(PerfEvent event) const {
+  return fds_[static_cast<std::size_t>(event)] != -1;
+}
+
+bool PerfCounters::anyAvailable() const {
+  for (const int fd : fds_) {
+    if (fd != -1) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace euler
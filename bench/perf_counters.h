@@ -0,0 +1,74 @@
+#ifndef EULER_BENCH_PERF_COUNTERS_H
+#define EULER_BENCH_PERF_COUNTERS_H
+
+#include <cstddef>
+#include <string>
+
+namespace euler {
+
+/**
+ * @brief Hardware events counted by PerfCounters
+ */
+enum class PerfEvent { CYCLES, INSTRUCTIONS, CACHE_MISSES, BRANCH_MISSES };
+
+/// Number of PerfEvents
+constexpr std::size_t PERF_EVENT_COUNT = 4;
+
+/**
+ * @brief Hardware performance counters of the calling process, read through perf_event_open
+ *
+ * @details Events are counted in user space only, which perf_event_paranoid levels up to 2 allow,
+ * and are inherited by threads started while counting, so thread pools are counted too. The events
+ * are opened as one group, which the kernel schedules onto the PMU all at once, so ratios such as
+ * instructions per cycle compare counts over the same time even when it multiplexes counters; the
+ * counts are then scaled by the fraction of the time the group ran. Each event that cannot be
+ * opened (no PMU in a virtual machine, a stricter paranoid level, another operating system) is
+ * simply unavailable.
+ */
+class PerfCounters {
+ public:
+  PerfCounters();
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+  ~PerfCounters();
+
+  /**
+   * @brief Determines if an event is counted
+   */
+  bool available(PerfEvent event) const;
+
+  /**
+   * @brief Determines if any event is counted
+   */
+  bool anyAvailable() const;
+
+  /**
+   * @brief Describes why the first unavailable event could not be opened, empty if none
+   */
+  const std::string& error() const { return error_; }
+
+  /**
+   * @brief Resets the counts of every available event to zero and starts counting
+   */
+  void start();
+
+  /**
+   * @brief Stops counting and reads the counts of every available event together
+   */
+  void stop();
+
+  /**
+   * @brief Returns the count of an event between start and stop, or NaN if it is unavailable
+   */
+  double count(PerfEvent event) const;
+
+ private:
+  int fds_[PERF_EVENT_COUNT];
+  int leader_;  ///< First event opened, which the others are grouped with, or -1 if none
+  double counts_[PERF_EVENT_COUNT];
+  std::string error_;
+};
+
+}  // namespace euler
+
+#endif
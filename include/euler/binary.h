@@ -0,0 +1,119 @@
+#ifndef EULER_BINARY_H
+#define EULER_BINARY_H
+
+#include <euler/rotations.h>
+
+#include <cstddef>
+#include <string>
+
+namespace euler {
+
+/**
+ * @brief One output record of the binary format
+ *
+ * @details Input records are Angles: three native-endian float64 values (24 bytes). Output records
+ * are thirteen native-endian float64 values (104 bytes): the rotation matrix in row-major order
+ * followed by the quaternion (w, x, y, z). Files hold records back to back with no header.
+ */
+struct BinaryRecord {
+  RotationMatrix R;  ///< Rotation matrix, row-major
+  Quaternion q;      ///< Unit quaternion (w, x, y, z)
+};
+
+/// Size in bytes of one input record of the binary format
+constexpr std::size_t BINARY_ANGLES_SIZE = sizeof(Angles);
+
+/// Size in bytes of one output record of the binary format
+constexpr std::size_t BINARY_RECORD_SIZE = sizeof(BinaryRecord);
+
+/**
+ * @brief Converts a contiguous batch of Euler angles into binary output records
+ *
+ * @details Equivalent to the batch toRotationMatrix and toQuaternion, with the results interleaved
+ * as records so that out can point straight into a mapped output file.
+ *
+ * @param[in] sequence Rotation sequence of all angles
+ * @param[in] angles Pointer to the first of count sets of angles in radians
+ * @param[in] count Number of sets of angles
+ * @param[in] convention Rotation convention of all angles
+ * @param[out] out Pointer to storage for count records (may not alias angles)
+ */
+void toBinaryRecords(Sequence sequence, const Angles* angles, std::size_t count,
+                     Convention convention, BinaryRecord* out);
+
+/**
+ * @brief A file mapped into memory with mmap
+ *
+ * @details Unmapped and closed on destruction. Files of size zero are opened but not mapped, in
+ * which case data() is null.
+ */
+class MappedFile {
+ public:
+  MappedFile() = default;
+  MappedFile(MappedFile&& other);
+  MappedFile& operator=(MappedFile&& other);
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile();
+
+  /**
+   * @brief Maps an existing regular file for reading
+   *
+   * @param[in] path Path of the file
+   *
+   * @return True on success, false if the file cannot be opened, is not a regular file, or cannot
+   * be mapped
+   */
+  bool openRead(const std::string& path);
+
+  /**
+   * @brief Creates (or truncates) a file of a given size and maps it for writing
+   *
+   * @details The blocks of the file are allocated up front, so a full disk fails here rather than
+   * with SIGBUS when the mapping is written.
+   *
+   * @param[in] path Path of the file
+   * @param[in] size Size of the file in bytes
+   * @param[in] exclusive True to fail rather than truncate if the file already exists
+   *
+   * @return True on success, false if the file cannot be created, allocated or mapped
+   */
+  bool create(const std::string& path, std::size_t size, bool exclusive = false);
+
+  /**
+   * @brief Writes the changes made through the mapping back to the file and waits for them
+   *
+   * @return True on success or if nothing is mapped, false if the file could not be written
+   */
+  bool sync();
+
+  /**
+   * @brief Maps an existing regular file for reading and writing, sharing changes with every other
+   * mapping of the file
+   *
+   * @param[in] path Path of the file
+   *
+   * @return True on success, false if the file cannot be opened, is not a regular file, or cannot
+   * be mapped
+   */
+  bool openShared(const std::string& path);
+
+  /**
+   * @brief Unmaps and closes the file, if open
+   */
+  void close();
+
+  bool isOpen() const { return fd_ != -1; }
+  char* data() { return data_; }
+  const char* data() const { return data_; }
+  std::size_t size() const { return size_; }
+
+ private:
+  int fd_ = -1;
+  char* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+}  // namespace euler
+
+#endif
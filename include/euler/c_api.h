@@ -0,0 +1,135 @@
+#ifndef EULER_C_API_H
+#define EULER_C_API_H
+
+/*
+ * C interface to the euler rotations library, for callers in C and for foreign function interfaces
+ * (ctypes, cffi, Rust, Julia, ...). Every function converts a whole batch between flat arrays of
+ * doubles:
+ *   - angles: 3 doubles per rotation, in radians and in the same order as the sequence
+ *   - rotation matrices: 9 doubles per rotation, in row-major order
+ *   - unit quaternions: 4 doubles per rotation, in w, x, y, z order
+ * Output arrays may not overlap input arrays. Pointers may be null when n is zero.
+ *
+ * The functions are exported by the euler shared library, and only their names, the values of the
+ * constants below and the layouts of the arrays make up the ABI. EULER_C_API_VERSION changes only
+ * when that ABI does.
+ */
+
+#include <stddef.h>
+
+#define EULER_C_EXPORT __attribute__((visibility("default")))
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Version of the C interface */
+#define EULER_C_API_VERSION 1
+
+/** Rotation sequences, the seq argument of the conversions */
+enum euler_sequence {
+  EULER_XYZ = 0,
+  EULER_XZY = 1,
+  EULER_YXZ = 2,
+  EULER_YZX = 3,
+  EULER_ZXY = 4,
+  EULER_ZYX = 5,
+  EULER_XYX = 6,
+  EULER_XZX = 7,
+  EULER_YXY = 8,
+  EULER_YZY = 9,
+  EULER_ZXZ = 10,
+  EULER_ZYZ = 11
+};
+
+/** Flags of conventions, combined into the conv argument (e.g. EULER_EXTRINSIC | EULER_PASSIVE) */
+enum euler_convention {
+  EULER_INTRINSIC = 0,
+  EULER_EXTRINSIC = 1,
+  EULER_ACTIVE = 0,
+  EULER_PASSIVE = 2
+};
+
+/** Return values of the conversions */
+enum euler_status {
+  EULER_OK = 0,
+  EULER_INVALID_SEQUENCE = -1,   /**< seq is not an euler_sequence */
+  EULER_INVALID_CONVENTION = -2, /**< conv holds bits other than the euler_convention flags */
+  EULER_INVALID_POINTER = -3     /**< A pointer is null although n is not zero */
+};
+
+/**
+ * @brief Returns EULER_C_API_VERSION of the library actually loaded
+ */
+EULER_C_EXPORT int euler_api_version(void);
+
+/**
+ * @brief Parses the name of a sequence (e.g. "zyx")
+ *
+ * @return The euler_sequence, or EULER_INVALID_SEQUENCE if name is not a valid sequence
+ */
+EULER_C_EXPORT int euler_parse_sequence(const char* name);
+
+/**
+ * @brief Converts n sets of Euler angles to rotation matrices
+ *
+ * @param[in] angles 3 * n angles in radians
+ * @param[in] n Number of rotations
+ * @param[in] seq An euler_sequence
+ * @param[in] conv euler_convention flags
+ * @param[out] out Storage for 9 * n elements of rotation matrices
+ *
+ * @return EULER_OK, or an euler_status describing why nothing was converted
+ */
+EULER_C_EXPORT int euler_to_matrix_batch(const double* angles, size_t n, int seq, int conv,
+                                         double* out);
+
+/**
+ * @brief Converts n sets of Euler angles to unit quaternions
+ *
+ * @param[out] out Storage for 4 * n elements of unit quaternions
+ *
+ * @return EULER_OK, or an euler_status describing why nothing was converted
+ */
+EULER_C_EXPORT int euler_to_quaternion_batch(const double* angles, size_t n, int seq, int conv,
+                                             double* out);
+
+/**
+ * @brief Converts n sets of Euler angles to both rotation matrices and unit quaternions
+ *
+ * @param[out] matrices Storage for 9 * n elements of rotation matrices
+ * @param[out] quaternions Storage for 4 * n elements of unit quaternions
+ *
+ * @return EULER_OK, or an euler_status describing why nothing was converted
+ */
+EULER_C_EXPORT int euler_to_matrix_quaternion_batch(const double* angles, size_t n, int seq,
+                                                    int conv, double* matrices,
+                                                    double* quaternions);
+
+/**
+ * @brief Converts n rotation matrices (assumed to be orthonormal) to Euler angles
+ *
+ * @param[in] matrices 9 * n elements of rotation matrices
+ * @param[out] out Storage for 3 * n angles in radians
+ *
+ * @return EULER_OK, or an euler_status describing why nothing was converted
+ */
+EULER_C_EXPORT int euler_matrix_to_angles_batch(const double* matrices, size_t n, int seq,
+                                                int conv, double* out);
+
+/**
+ * @brief Converts n unit quaternions to Euler angles
+ *
+ * @param[in] quaternions 4 * n elements of unit quaternions
+ * @param[out] out Storage for 3 * n angles in radians
+ *
+ * @return EULER_OK, or an euler_status describing why nothing was converted
+ */
+EULER_C_EXPORT int euler_quaternion_to_angles_batch(const double* quaternions, size_t n, int seq,
+                                                    int conv, double* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
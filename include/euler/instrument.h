@@ -0,0 +1,120 @@
+#ifndef EULER_INSTRUMENT_H
+#define EULER_INSTRUMENT_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/// Set to 0 to compile the probes and the trace out (the EULER_INSTRUMENTATION option)
+#ifndef EULER_INSTRUMENTATION
+#define EULER_INSTRUMENTATION 1
+#endif
+
+namespace euler {
+
+/**
+ * @brief Hot paths whose calls, records and time are accumulated
+ *
+ * @details The batch conversions and the pipeline of the CLI time themselves once per call, so the
+ * two readings of the clock are spread over a whole batch or block. Single conversions and batches
+ * of fewer than PROBE_MIN_RECORDS records are not timed, since reading the clock would cost about
+ * as much as converting.
+ */
+enum class Probe {
+  PARSE,            ///< Parsing lines of text into angles
+  ROTATION_MATRIX,  ///< Batch toRotationMatrix
+  QUATERNION,       ///< Batch toQuaternion
+  FORMAT            ///< Formatting results as lines of text
+};
+
+/// Number of probes
+constexpr std::size_t PROBE_COUNT = 4;
+
+/// Smallest batch whose call is timed and counted by a ProbeTimer given its number of records
+constexpr std::size_t PROBE_MIN_RECORDS = 64;
+
+/**
+ * @brief Totals of a probe since the program started or resetProbes was called
+ *
+ * @details Times are summed over threads, so they measure work rather than elapsed time.
+ */
+struct ProbeTotals {
+  std::uint64_t calls;
+  std::uint64_t records;
+  std::uint64_t nanoseconds;
+};
+
+/**
+ * @brief Returns the name of a probe, e.g. "toRotationMatrix"
+ */
+const char* probeName(Probe probe);
+
+/**
+ * @brief Adds one call over a number of records to the totals of a probe (thread-safe)
+ */
+void addProbe(Probe probe, std::size_t records, std::uint64_t nanoseconds);
+
+/**
+ * @brief Adds a call from start until now to the totals of a probe, and to the trace if tracing
+ * (see euler/trace.h)
+ */
+void finishProbe(Probe probe, std::size_t records, std::chrono::steady_clock::time_point start);
+
+/**
+ * @brief Returns the totals of a probe, all zero if the instrumentation is compiled out
+ */
+ProbeTotals probeTotals(Probe probe);
+
+/**
+ * @brief Sets the totals of every probe back to zero
+ */
+void resetProbes();
+
+/**
+ * @brief Times a scope and adds it to a probe when destroyed, unless the instrumentation is
+ * compiled out, in which case it does nothing at all
+ */
+class ProbeTimer {
+ public:
+#if EULER_INSTRUMENTATION
+  /// Times a call over a number of records, unless there are fewer than PROBE_MIN_RECORDS
+  ProbeTimer(Probe probe, std::size_t records)
+      : probe_(probe), records_(records), timing_(records >= PROBE_MIN_RECORDS) {
+    if (timing_) {
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  /// Times a call whose records are only known as they are found, see addRecords
+  explicit ProbeTimer(Probe probe)
+      : probe_(probe), records_(0), timing_(true), start_(std::chrono::steady_clock::now()) {}
+
+  ~ProbeTimer() {
+    if (timing_) {
+      finishProbe(probe_, records_, start_);
+    }
+  }
+
+  /// Adds records found while timing, when their number is not known up front
+  void addRecords(std::size_t records) { records_ += records; }
+#else
+  ProbeTimer(Probe, std::size_t) {}
+  explicit ProbeTimer(Probe) {}
+  void addRecords(std::size_t) {}
+#endif
+
+  ProbeTimer(const ProbeTimer&) = delete;
+  ProbeTimer& operator=(const ProbeTimer&) = delete;
+
+#if EULER_INSTRUMENTATION
+ private:
+  Probe probe_;
+  std::size_t records_;
+  bool timing_;
+  std::chrono::steady_clock::time_point start_;
+#endif
+};
+
+}  // namespace euler
+
+#endif
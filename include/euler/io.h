@@ -3,6 +3,7 @@
 
 #include <euler/rotations.h>
 
+#include <cstddef>
 #include <iostream>
 
 namespace euler {
@@ -15,7 +16,109 @@ namespace euler {
  *
  * @return True if the input sequence is a valid rotation sequence, false otherwise.
  */
-bool isSequenceValid(const Sequence& sequence);
+bool isSequenceValid(Sequence sequence);
+
+/**
+ * @brief Reason why text could not be parsed
+ */
+enum class ParseError {
+  NONE,             ///< Parsed successfully
+  EMPTY_LINE,       ///< The line holds nothing but whitespace
+  INVALID_NUMBER,   ///< A field is not a decimal real number
+  OUT_OF_RANGE,     ///< A number is too large to be represented as a double
+  TOO_FEW_ANGLES,   ///< The line holds fewer than three numbers
+  TOO_MANY_ANGLES,  ///< The line holds more than three numbers
+};
+
+/**
+ * @brief Result of parsing text
+ */
+struct ParseResult {
+  const char* ptr;   ///< One past the last character consumed
+  ParseError error;  ///< Reason for failure, or ParseError::NONE
+};
+
+/**
+ * @brief Parses a decimal real number from the start of a character buffer
+ *
+ * @details Follows the semantics of std::from_chars: no leading whitespace or plus sign is
+ * accepted, the decimal point is always '.', regardless of locale, and nothing is thrown. The
+ * result is correctly rounded. Accepts an optional minus sign, digits with an optional fraction,
+ * and an optional exponent (e.g., -12.5e-3).
+ *
+ * @param[in] first Start of the buffer
+ * @param[in] last End of the buffer
+ * @param[out] value The parsed number (unmodified on failure)
+ *
+ * @return Pointer one past the number and ParseError::NONE on success; first and the reason
+ * otherwise
+ */
+ParseResult parseDouble(const char* first, const char* last, double& value);
+
+/**
+ * @brief Parses one line of three angles from a character buffer
+ *
+ * @details The angles are separated by spaces, tabs or commas. The line ends at a newline (which
+ * is consumed, along with a preceding carriage return) or at the end of the buffer. Like
+ * parseDouble, this never throws.
+ *
+ * @param[in] first Start of the line
+ * @param[in] last End of the buffer
+ * @param[out] angles The parsed angles (unspecified on failure)
+ *
+ * @return Pointer to the start of the next line, and ParseError::NONE or the reason the line is
+ * not three real numbers
+ */
+ParseResult parseAngles(const char* first, const char* last, Angles& angles);
+
+/// Number of characters that always suffices for one call to format or formatCompact
+constexpr std::size_t MAX_FORMAT_LENGTH = 3072;
+
+/**
+ * @brief Writes the elements of a quaternion to a buffer, in the same layout as operator<<
+ *
+ * @details Numbers have four decimal places and are converted without iostreams or locales. The
+ * output is identical to that of operator<<, but is not null-terminated.
+ *
+ * @param[out] out Buffer with room for at least MAX_FORMAT_LENGTH characters
+ * @param[in] q Quaternion to format
+ *
+ * @return Pointer one past the last character written
+ */
+char* format(char* out, const Quaternion& q);
+
+/**
+ * @brief Writes the elements of a rotation matrix to a buffer, in the same layout as operator<<
+ *
+ * @param[out] out Buffer with room for at least MAX_FORMAT_LENGTH characters
+ * @param[in] R Rotation matrix to format
+ *
+ * @return Pointer one past the last character written
+ */
+char* format(char* out, const RotationMatrix& R);
+
+/**
+ * @brief Writes the elements of a quaternion (w, x, y, z) to a buffer on one line
+ *
+ * @details Numbers have four decimal places and are separated by single spaces. No newline is
+ * written.
+ *
+ * @param[out] out Buffer with room for at least MAX_FORMAT_LENGTH characters
+ * @param[in] q Quaternion to format
+ *
+ * @return Pointer one past the last character written
+ */
+char* formatCompact(char* out, const Quaternion& q);
+
+/**
+ * @brief Writes the elements of a rotation matrix, in row-major order, to a buffer on one line
+ *
+ * @param[out] out Buffer with room for at least MAX_FORMAT_LENGTH characters
+ * @param[in] R Rotation matrix to format
+ *
+ * @return Pointer one past the last character written
+ */
+char* formatCompact(char* out, const RotationMatrix& R);
 
 /**
  * @brief Pretty print the element of a quaternion
@@ -0,0 +1,178 @@
+#ifndef EULER_KERNELS_H
+#define EULER_KERNELS_H
+
+#include <euler/rotations.h>
+
+#include <cmath>
+
+namespace euler {
+namespace kernels {
+
+/// Cosines and sines of three angles, in the order their elemental rotations are applied
+struct Trig {
+  double c1, s1, c2, s2, c3, s3;
+};
+
+/**
+ * @brief Closed-form active, intrinsic rotation matrix R_1(a_1) * R_2(a_2) * R_3(a_3)
+ *
+ * @details Only the 12 valid sequences are specialized.
+ *
+ * @param[in] t Cosines and sines of a_1, a_2 and a_3
+ *
+ * @return The resulting rotation matrix
+ */
+template <Axis A1, Axis A2, Axis A3>
+RotationMatrix R_active(const Trig& t);
+
+// clang-format off
+template <>
+inline RotationMatrix R_active<Axis::X, Axis::Y, Axis::Z>(const Trig& t) {
+  const auto s1s2 = t.s1 * t.s2;
+  const auto c1s2 = t.c1 * t.s2;
+  return {          t.c2 * t.c3,            -t.c2 * t.s3,          t.s2,
+          t.c1 * t.s3 + s1s2 * t.c3, t.c1 * t.c3 - s1s2 * t.s3, -t.s1 * t.c2,
+          t.s1 * t.s3 - c1s2 * t.c3, t.s1 * t.c3 + c1s2 * t.s3,  t.c1 * t.c2};
+}
+
+template <>
+inline RotationMatrix R_active<Axis::X, Axis::Z, Axis::Y>(const Trig& t) {
+  const auto s1s2 = t.s1 * t.s2;
+  const auto c1s2 = t.c1 * t.s2;
+  return {          t.c2 * t.c3,              -t.s2,               t.c2 * t.s3,
+          t.s1 * t.s3 + c1s2 * t.c3,  t.c1 * t.c2, c1s2 * t.s3 - t.s1 * t.c3,
+          s1s2 * t.c3 - t.c1 * t.s3,  t.s1 * t.c2, t.c1 * t.c3 + s1s2 * t.s3};
+}
+
+template <>
+inline RotationMatrix R_active<Axis::Y, Axis::X, Axis::Z>(const Trig& t) {
+  const auto s1s2 = t.s1 * t.s2;
+  const auto c1s2 = t.c1 * t.s2;
+  return {t.c1 * t.c3 + s1s2 * t.s3, s1s2 * t.c3 - t.c1 * t.s3,  t.s1 * t.c2,
+                   t.c2 * t.s3,               t.c2 * t.c3,         -t.s2,
+          c1s2 * t.s3 - t.s1 * t.c3, t.s1 * t.s3 + c1s2 * t.c3,  t.c1 * t.c2};
+}
+
+template <>
+inline RotationMatrix R_active<Axis::Y, Axis::Z, Axis::X>(const Trig& t) {
+  const auto s1s2 = t.s1 * t.s2;
+  const auto c1s2 = t.c1 * t.s2;
+  return { t.c1 * t.c2, t.s1 * t.s3 - c1s2 * t.c3, t.s1 * t.c3 + c1s2 * t.s3,
+                 t.s2,           t.c2 * t.c3,              -t.c2 * t.s3,
+          -t.s1 * t.c2, t.c1 * t.s3 + s1s2 * t.c3, t.c1 * t.c3 - s1s2 * t.s3};
+}
+
+template <>
+inline RotationMatrix R_active<Axis::Z, Axis::X, Axis::Y>(const Trig& t) {
+  const auto s1s2 = t.s1 * t.s2;
+  const auto c1s2 = t.c1 * t.s2;
+  return {t.c1 * t.c3 - s1s2 * t.s3, -t.s1 * t.c2, t.c1 * t.s3 + s1s2 * t.c3,
+          t.s1 * t.c3 + c1s2 * t.s3,  t.c1 * t.c2, t.s1 * t.s3 - c1s2 * t.c3,
+                  -t.c2 * t.s3,             t.s2,          t.c2 * t.c3};
+}
+
+template <>
+inline RotationMatrix R_active<Axis::Z, Axis::Y, Axis::X>(const Trig& t) {
+  const auto s1s2 = t.s1 * t.s2;
+  const auto c1s2 = t.c1 * t.s2;
+  return {t.c1 * t.c2, c1s2 * t.s3 - t.s1 * t.c3, t.s1 * t.s3 + c1s2 * t.c3,
+          t.s1 * t.c2, t.c1 * t.c3 + s1s2 * t.s3, s1s2 * t.c3 - t.c1 * t.s3,
+                -t.s2,          t.c2 * t.s3,               t.c2 * t.c3};
+}
+
+template <>
+inline RotationMatrix R_active<Axis::X, Axis::Y, Axis::X>(const Trig& t) {
+  const auto c1c2 = t.c1 * t.c2;
+  const auto s1c2 = t.s1 * t.c2;
+  return {        t.c2,                   t.s2 * t.s3,               t.s2 * t.c3,
+           t.s1 * t.s2, t.c1 * t.c3 - s1c2 * t.s3, -t.c1 * t.s3 - s1c2 * t.c3,
+          -t.c1 * t.s2, t.s1 * t.c3 + c1c2 * t.s3,  c1c2 * t.c3 - t.s1 * t.s3};
+}
+
+template <>
+inline RotationMatrix R_active<Axis::X, Axis::Z, Axis::X>(const Trig& t) {
+  const auto c1c2 = t.c1 * t.c2;
+  const auto s1c2 = t.s1 * t.c2;
+  return {       t.c2,                  -t.s2 * t.c3,               t.s2 * t.s3,
+          t.c1 * t.s2, c1c2 * t.c3 - t.s1 * t.s3, -t.s1 * t.c3 - c1c2 * t.s3,
+          t.s1 * t.s2, t.c1 * t.s3 + s1c2 * t.c3,  t.c1 * t.c3 - s1c2 * t.s3};
+}
+
+template <>
+inline RotationMatrix R_active<Axis::Y, Axis::X, Axis::Y>(const Trig& t) {
+  const auto c1c2 = t.c1 * t.c2;
+  const auto s1c2 = t.s1 * t.c2;
+  return { t.c1 * t.c3 - s1c2 * t.s3, t.s1 * t.s2, t.c1 * t.s3 + s1c2 * t.c3,
+                    t.s2 * t.s3,             t.c2,              -t.s2 * t.c3,
+          -t.s1 * t.c3 - c1c2 * t.s3, t.c1 * t.s2, c1c2 * t.c3 - t.s1 * t.s3};
+}
+
+template <>
+inline RotationMatrix R_active<Axis::Y, Axis::Z, Axis::Y>(const Trig& t) {
+  const auto c1c2 = t.c1 * t.c2;
+  const auto s1c2 = t.s1 * t.c2;
+  return { c1c2 * t.c3 - t.s1 * t.s3, -t.c1 * t.s2, t.s1 * t.c3 + c1c2 * t.s3,
+                    t.s2 * t.c3,              t.c2,               t.s2 * t.s3,
+          -t.c1 * t.s3 - s1c2 * t.c3,  t.s1 * t.s2, t.c1 * t.c3 - s1c2 * t.s3};
+}
+
+template <>
+inline RotationMatrix R_active<Axis::Z, Axis::X, Axis::Z>(const Trig& t) {
+  const auto c1c2 = t.c1 * t.c2;
+  const auto s1c2 = t.s1 * t.c2;
+  return {t.c1 * t.c3 - s1c2 * t.s3, -t.c1 * t.s3 - s1c2 * t.c3,  t.s1 * t.s2,
+          t.s1 * t.c3 + c1c2 * t.s3,  c1c2 * t.c3 - t.s1 * t.s3, -t.c1 * t.s2,
+                   t.s2 * t.s3,                t.s2 * t.c3,             t.c2};
+}
+
+template <>
+inline RotationMatrix R_active<Axis::Z, Axis::Y, Axis::Z>(const Trig& t) {
+  const auto c1c2 = t.c1 * t.c2;
+  const auto s1c2 = t.s1 * t.c2;
+  return { c1c2 * t.c3 - t.s1 * t.s3, -t.s1 * t.c3 - c1c2 * t.s3, t.c1 * t.s2,
+           t.c1 * t.s3 + s1c2 * t.c3,  t.c1 * t.c3 - s1c2 * t.s3, t.s1 * t.s2,
+                  -t.s2 * t.c3,                t.s2 * t.s3,             t.c2};
+}
+// clang-format on
+
+/**
+ * @brief Adds zero to every element of a rotation matrix
+ *
+ * @details Turns the negative zeros of the closed forms into the positive zeros produced by
+ * multiplying out the elemental rotations.
+ *
+ * @param[in] R Rotation matrix from one of the closed forms
+ *
+ * @return R without negative zeros
+ */
+inline RotationMatrix positiveZeros(RotationMatrix R) {
+  for (auto& r : R) {
+    r += 0.0;
+  }
+  return R;
+}
+
+}  // namespace kernels
+
+template <Axis A1, Axis A2, Axis A3, Order ORDER, Direction DIRECTION>
+RotationMatrix toRotationMatrix(const Angles& angles) {
+  static_assert(A1 != A2 && A2 != A3, "Consecutive axes of a sequence must differ");
+
+  // Every convention reduces to an active, intrinsic kernel by reversing the angles and/or
+  // negating their sines (see kernels::Dispatch in rotations_impl.h)
+  constexpr bool active = DIRECTION == Direction::ACTIVE;
+  constexpr bool reverse = (ORDER == Order::INTRINSIC) != active;
+  const double sign = active ? 1.0 : -1.0;
+
+  const auto a1 = reverse ? angles[2] : angles[0];
+  const auto a2 = angles[1];
+  const auto a3 = reverse ? angles[0] : angles[2];
+  const kernels::Trig t = {std::cos(a1), sign * std::sin(a1), std::cos(a2),
+                           sign * std::sin(a2), std::cos(a3), sign * std::sin(a3)};
+  return kernels::positiveZeros(
+      kernels::R_active<(reverse ? A3 : A1), A2, (reverse ? A1 : A3)>(t));
+}
+
+}  // namespace euler
+
+#endif
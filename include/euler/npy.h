@@ -0,0 +1,149 @@
+#ifndef EULER_NPY_H
+#define EULER_NPY_H
+
+#include <euler/binary.h>
+#include <euler/rotations.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace euler {
+
+/**
+ * @brief Reason why a .npy file could not be read or written
+ */
+enum class NpyError {
+  NONE,              ///< Read or written successfully
+  CANNOT_OPEN,       ///< The file cannot be opened, created or mapped
+  INVALID_HEADER,    ///< The file does not start with a valid .npy header of an addressable shape
+  UNSUPPORTED_TYPE,  ///< The elements are not little-endian float32 or float64
+  INVALID_SHAPE,     ///< The array does not have the expected shape
+  TRUNCATED,         ///< The file is smaller than its header says
+  CANNOT_WRITE       ///< The elements could not be written back to the file
+};
+
+/**
+ * @brief Type of the elements of a .npy array
+ */
+enum class NpyType {
+  FLOAT32,  ///< Little-endian float32 ('<f4')
+  FLOAT64   ///< Little-endian float64 ('<f8')
+};
+
+/**
+ * @brief An array in a memory-mapped .npy file
+ *
+ * @details Supports versions 1.0 to 3.0 of the format with float32 or float64 elements, in C or
+ * Fortran order. Files created by create are version 1.0 and hold float64 elements in C order,
+ * starting at an offset that is a multiple of 64 bytes.
+ */
+class NpyArray {
+ public:
+  /**
+   * @brief Maps an existing .npy file for reading
+   *
+   * @param[in] path Path of the file
+   *
+   * @return NpyError::NONE on success, otherwise the reason the file cannot be used
+   */
+  NpyError openRead(const std::string& path);
+
+  /**
+   * @brief Creates (or truncates) a .npy file of float64 elements and maps it for writing
+   *
+   * @param[in] path Path of the file
+   * @param[in] shape Shape of the array
+   *
+   * @return NpyError::NONE on success, otherwise NpyError::CANNOT_OPEN
+   */
+  NpyError create(const std::string& path, const std::vector<std::size_t>& shape);
+
+  /**
+   * @brief Writes the elements written through data() back to a created file
+   *
+   * @return True on success, false if the file could not be written
+   */
+  bool sync() { return file_.sync(); }
+
+  NpyType type() const { return type_; }
+  bool fortranOrder() const { return fortran_order_; }
+  const std::vector<std::size_t>& shape() const { return shape_; }
+
+  /// Pointer to the first element of the array
+  char* data() { return data_; }
+  const char* data() const { return data_; }
+
+ private:
+  MappedFile file_;
+  NpyType type_ = NpyType::FLOAT64;
+  bool fortran_order_ = false;
+  std::vector<std::size_t> shape_;
+  char* data_ = nullptr;
+};
+
+/**
+ * @brief Checks that an array holds sets of Euler angles, i.e., that it has shape (N, 3)
+ *
+ * @param[in] array Array opened with NpyArray::openRead
+ *
+ * @return NpyError::NONE if the array holds angles, NpyError::INVALID_SHAPE otherwise
+ */
+NpyError checkAngles(const NpyArray& array);
+
+/**
+ * @brief Returns the sets of angles of an array of shape (N, 3) without copying them
+ *
+ * @param[in] array Array of angles
+ *
+ * @return Pointer to the N sets of angles if they are float64 in C order, null otherwise
+ */
+const Angles* anglesData(const NpyArray& array);
+
+/**
+ * @brief Copies sets of angles out of an array of shape (N, 3), converting them to double
+ *
+ * @param[in] array Array of angles
+ * @param[in] first Index of the first set of angles to copy
+ * @param[in] count Number of sets of angles to copy (first + count may not exceed N)
+ * @param[out] out Pointer to storage for count sets of angles
+ */
+void readAngles(const NpyArray& array, std::size_t first, std::size_t count, Angles* out);
+
+/**
+ * @brief Reads every set of angles of a .npy file of shape (N, 3)
+ *
+ * @param[in] path Path of the file
+ * @param[out] angles The N sets of angles
+ *
+ * @return NpyError::NONE on success, otherwise the reason the file cannot be read
+ */
+NpyError readNpy(const std::string& path, std::vector<Angles>& angles);
+
+/**
+ * @brief Writes rotation matrices to a .npy file of shape (N, 3, 3)
+ *
+ * @param[in] path Path of the file
+ * @param[in] R Pointer to the first of count rotation matrices
+ * @param[in] count Number of rotation matrices
+ *
+ * @return NpyError::NONE on success, NpyError::CANNOT_OPEN if the file cannot be created or
+ * NpyError::CANNOT_WRITE if the elements cannot be written to it
+ */
+NpyError writeNpy(const std::string& path, const RotationMatrix* R, std::size_t count);
+
+/**
+ * @brief Writes quaternions (w, x, y, z) to a .npy file of shape (N, 4)
+ *
+ * @param[in] path Path of the file
+ * @param[in] q Pointer to the first of count quaternions
+ * @param[in] count Number of quaternions
+ *
+ * @return NpyError::NONE on success, NpyError::CANNOT_OPEN if the file cannot be created or
+ * NpyError::CANNOT_WRITE if the elements cannot be written to it
+ */
+NpyError writeNpy(const std::string& path, const Quaternion* q, std::size_t count);
+
+}  // namespace euler
+
+#endif
@@ -0,0 +1,154 @@
+#ifndef EULER_PARALLEL_H
+#define EULER_PARALLEL_H
+
+#include <euler/binary.h>
+#include <euler/rotations.h>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace euler {
+
+/// Number of records handed to a thread at a time; the angles and results of one chunk fit in L2
+constexpr std::size_t PARALLEL_CHUNK_SIZE = 2048;
+
+/**
+ * @brief A fixed set of threads that run loops over chunks of a range with work stealing
+ *
+ * @details Each call to parallelFor splits the range evenly between the threads. A thread takes
+ * chunks from the front of its own share and, once that is exhausted, steals the back half of what
+ * remains of the share of another thread, so that threads finishing early keep busy. The thread
+ * that calls parallelFor takes part, so a pool of size one runs everything on the calling thread.
+ */
+class ThreadPool {
+ public:
+  /**
+   * @brief Starts the threads of the pool
+   *
+   * @param[in] threads Number of threads, including the caller of parallelFor (0 for one per core)
+   */
+  explicit ThreadPool(std::size_t threads = 0);
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  ~ThreadPool();
+
+  /**
+   * @brief Returns the number of threads, including the caller of parallelFor
+   */
+  std::size_t size() const;
+
+  /**
+   * @brief Calls body(begin, end) for chunks [begin, end) covering [0, count) and returns once
+   * all of them are done
+   *
+   * @details Chunks are disjoint, hold at most chunk items and begin at a multiple of chunk. They
+   * run concurrently on the threads of the pool, in no particular order. Calls may not be nested
+   * or made concurrently from several threads.
+   *
+   * @param[in] count Number of items
+   * @param[in] chunk Maximum number of items per call to body (at least 1)
+   * @param[in] body Function to call for each chunk
+   */
+  void parallelFor(std::size_t count, std::size_t chunk,
+                   const std::function<void(std::size_t, std::size_t)>& body);
+
+ private:
+  struct State;
+  std::unique_ptr<State> state_;
+};
+
+/**
+ * @brief Batch toRotationMatrix run on the threads of a pool
+ *
+ * @param[in] sequence Rotation sequence of all angles
+ * @param[in] angles Pointer to the first of count sets of angles
+ * @param[in] count Number of sets of angles
+ * @param[in] convention Rotation convention of all angles
+ * @param[out] out Pointer to storage for count rotation matrices (may not alias angles)
+ * @param[in] pool Threads to run on
+ */
+void toRotationMatrix(Sequence sequence, const Angles* angles, std::size_t count,
+                      Convention convention, RotationMatrix* out, ThreadPool& pool);
+
+/**
+ * @brief Batch toQuaternion run on the threads of a pool
+ *
+ * @param[in] sequence Rotation sequence of all angles
+ * @param[in] angles Pointer to the first of count sets of angles
+ * @param[in] count Number of sets of angles
+ * @param[in] convention Rotation convention of all angles
+ * @param[out] out Pointer to storage for count quaternions (may not alias angles)
+ * @param[in] pool Threads to run on
+ */
+void toQuaternion(Sequence sequence, const Angles* angles, std::size_t count,
+                  Convention convention, Quaternion* out, ThreadPool& pool);
+
+/**
+ * @brief Batch toRotationMatrix with one sequence and convention per record run on the threads of
+ * a pool
+ *
+ * @param[in] codes Pointer to the valid sequence and convention of each of count sets of angles
+ * @param[in] angles Pointer to the first of count sets of angles
+ * @param[in] count Number of sets of angles
+ * @param[out] out Pointer to storage for count rotation matrices (may not alias angles)
+ * @param[in] pool Threads to run on
+ */
+void toRotationMatrix(const ConventionCode* codes, const Angles* angles, std::size_t count,
+                      RotationMatrix* out, ThreadPool& pool);
+
+/**
+ * @brief Batch toQuaternion with one sequence and convention per record run on the threads of a
+ * pool
+ *
+ * @param[in] codes Pointer to the valid sequence and convention of each of count sets of angles
+ * @param[in] angles Pointer to the first of count sets of angles
+ * @param[in] count Number of sets of angles
+ * @param[out] out Pointer to storage for count quaternions (may not alias angles)
+ * @param[in] pool Threads to run on
+ */
+void toQuaternion(const ConventionCode* codes, const Angles* angles, std::size_t count,
+                  Quaternion* out, ThreadPool& pool);
+
+/**
+ * @brief Batch toEulerAngles from rotation matrices run on the threads of a pool
+ *
+ * @param[in] R Pointer to the first of count rotation matrices
+ * @param[in] count Number of rotation matrices
+ * @param[in] sequence Rotation sequence of the angles
+ * @param[in] convention Rotation convention of the angles
+ * @param[out] out Pointer to storage for count sets of angles
+ * @param[in] pool Threads to run on
+ */
+void toEulerAngles(const RotationMatrix* R, std::size_t count, Sequence sequence,
+                   Convention convention, Angles* out, ThreadPool& pool);
+
+/**
+ * @brief Batch toEulerAngles from quaternions run on the threads of a pool
+ *
+ * @param[in] q Pointer to the first of count quaternions
+ * @param[in] count Number of quaternions
+ * @param[in] sequence Rotation sequence of the angles
+ * @param[in] convention Rotation convention of the angles
+ * @param[out] out Pointer to storage for count sets of angles
+ * @param[in] pool Threads to run on
+ */
+void toEulerAngles(const Quaternion* q, std::size_t count, Sequence sequence,
+                   Convention convention, Angles* out, ThreadPool& pool);
+
+/**
+ * @brief Batch toBinaryRecords run on the threads of a pool
+ *
+ * @param[in] sequence Rotation sequence of all angles
+ * @param[in] angles Pointer to the first of count sets of angles
+ * @param[in] count Number of sets of angles
+ * @param[in] convention Rotation convention of all angles
+ * @param[out] out Pointer to storage for count records (may not alias angles)
+ * @param[in] pool Threads to run on
+ */
+void toBinaryRecords(Sequence sequence, const Angles* angles, std::size_t count,
+                     Convention convention, BinaryRecord* out, ThreadPool& pool);
+
+}  // namespace euler
+
+#endif
@@ -0,0 +1,181 @@
+#ifndef EULER_QUEUE_H
+#define EULER_QUEUE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace euler {
+
+/**
+ * @brief A bounded, lock-free queue between one producer thread and one consumer thread
+ *
+ * @details Items live in a ring buffer whose capacity is a power of two. The producer only writes
+ * the tail index and the consumer only writes the head index, so neither push nor pop takes a
+ * lock while the other side is running. The blocking variants spin briefly, yielding the processor,
+ * while the queue is full or empty, and then sleep on a condition variable until the other side
+ * pushes, pops or closes, so idle stages of a pipeline use no processor time.
+ * Either side may close the queue: the producer to signal the end of its items, which the consumer
+ * still drains, or the consumer to tell the producer to stop.
+ */
+template <typename T>
+class SpscQueue {
+ public:
+  /**
+   * @brief Creates an empty queue
+   *
+   * @param[in] capacity Minimum number of items the queue can hold (rounded up to a power of two)
+   */
+  explicit SpscQueue(std::size_t capacity) {
+    std::size_t size = 1;
+    while (size < capacity) {
+      size *= 2;
+    }
+    slots_.resize(size);
+    mask_ = size - 1;
+  }
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  /**
+   * @brief Adds an item if there is room (producer only)
+   *
+   * @return True if the item was moved into the queue, false if the queue is full
+   */
+  bool tryPush(T& value) {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == slots_.size()) {
+      return false;
+    }
+    slots_[tail & mask_] = std::move(value);
+    tail_.store(tail + 1, std::memory_order_release);
+    wake();
+    return true;
+  }
+
+  /**
+   * @brief Adds an item, waiting while the queue is full (producer only)
+   *
+   * @return True if the item was moved into the queue, false if the queue was closed
+   */
+  bool push(T value) {
+    while (!closed()) {
+      if (tryPush(value)) {
+        return true;
+      }
+      wait([this] { return closed() || !full(); });
+    }
+    return false;
+  }
+
+  /**
+   * @brief Removes the oldest item if there is one (consumer only)
+   *
+   * @return True if an item was moved into value, false if the queue is empty
+   */
+  bool tryPop(T& value) {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    value = std::move(slots_[head & mask_]);
+    head_.store(head + 1, std::memory_order_release);
+    wake();
+    return true;
+  }
+
+  /**
+   * @brief Removes the oldest item, waiting while the queue is empty (consumer only)
+   *
+   * @return True if an item was moved into value, false if the queue is closed and empty
+   */
+  bool pop(T& value) {
+    while (!tryPop(value)) {
+      if (closed()) {
+        // Items pushed before the queue was closed are still delivered
+        return tryPop(value);
+      }
+      wait([this] { return closed() || !empty(); });
+    }
+    return true;
+  }
+
+  /**
+   * @brief Closes the queue; later pushes fail and pops fail once the queue is empty
+   */
+  void close() {
+    closed_.store(true, std::memory_order_release);
+    wake();
+  }
+
+  bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+  /// Maximum number of items in the queue
+  std::size_t capacity() const { return slots_.size(); }
+
+ private:
+  /// Number of times a blocking call checks the queue, yielding in between, before it sleeps
+  static constexpr int SPIN_COUNT = 64;
+
+  bool full() const {
+    return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire) ==
+           slots_.size();
+  }
+
+  bool empty() const {
+    return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Returns once ready() is true, spinning at first and then sleeping
+   *
+   * @details The sleeper is counted before it checks ready() under the mutex, and wake() reads the
+   * count after publishing its change; the fences on both sides ensure that either the sleeper
+   * sees the change or wake() sees the sleeper, so no wakeup is lost.
+   */
+  template <typename Ready>
+  void wait(Ready ready) {
+    for (int i = 0; i < SPIN_COUNT; ++i) {
+      if (ready()) {
+        return;
+      }
+      std::this_thread::yield();
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    sleepers_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    ready_.wait(lock, ready);
+    sleepers_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  /// Wakes the other side if it sleeps; takes no lock otherwise
+  void wake() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_relaxed) > 0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ready_.notify_all();
+    }
+  }
+
+  std::vector<T> slots_;
+  std::size_t mask_;
+
+  // The indices only ever grow; they are kept on separate cache lines to avoid false sharing
+  alignas(64) std::atomic<std::size_t> head_{0};
+  alignas(64) std::atomic<std::size_t> tail_{0};
+  alignas(64) std::atomic<bool> closed_{false};
+
+  // Only taken by a side about to sleep, and by the other side to wake it
+  alignas(64) std::atomic<int> sleepers_{0};
+  std::mutex mutex_;
+  std::condition_variable ready_;
+};
+
+}  // namespace euler
+
+#endif
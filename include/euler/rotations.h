@@ -2,13 +2,18 @@
 #define EULER_ROTATIONS_H
 
 #include <array>
+#include <cstddef>
+#include <cstdint>
 #include <ostream>
 #include <string>
 
-namespace euler {
-/// Rotation sequence (e.g., xyz, zxz, yxy, etc.)
-using Sequence = std::string;
+/// Set to 1 to define the single conversions and the matrix operations inline in this header, so
+/// callers can inline them (the EULER_INLINE_KERNELS option)
+#ifndef EULER_INLINE_KERNELS
+#define EULER_INLINE_KERNELS 0
+#endif
 
+namespace euler {
 /// Euler angles in the same order as the sequence
 using Angles = std::array<double, 3>;
 
@@ -18,6 +23,122 @@ using RotationMatrix = std::array<double, 9>;
 /// Unit quaternion stored in w, x, y, z order
 using Quaternion = std::array<double, 4>;
 
+/**
+ * @brief Principal axis of an elemental rotation
+ */
+enum class Axis { X, Y, Z };
+
+/**
+ * @brief The 12 valid rotation sequences: first the six with three different axes, then the six
+ * that repeat their first axis
+ */
+// clang-format off
+enum class SequenceId : std::uint8_t {
+  XYZ, XZY, YXZ, YZX, ZXY, ZYX,
+  XYX, XZX, YXY, YZY, ZXZ, ZYZ,
+  INVALID
+};
+// clang-format on
+
+/**
+ * @brief Rotation sequence (e.g., xyz, zxz, yxy, etc.)
+ *
+ * @details A sequence is parsed from its name once, when it is constructed, and takes a single
+ * byte. Names convert implicitly, so "zyx" or a std::string can be passed wherever a Sequence is
+ * expected; for string literals the parsing can happen at compile time, e.g.
+ * constexpr Sequence zyx = "zyx". Names that are not one of the 12 valid sequences give an invalid
+ * sequence, which must not be passed to the conversions.
+ */
+class Sequence {
+ public:
+  /// An invalid sequence
+  constexpr Sequence() : id_(SequenceId::INVALID) {}
+
+  constexpr Sequence(SequenceId id) : id_(id) {}
+
+  /// Parses a null-terminated name such as "zyx"
+  constexpr Sequence(const char* name) : id_(name == nullptr ? SequenceId::INVALID : parse(name)) {}
+
+  /// Parses a name such as "zyx"
+  Sequence(const std::string& name) : Sequence(name.data(), name.size()) {}
+
+  /// Parses a name of a given length
+  constexpr Sequence(const char* name, std::size_t length)
+      : id_(length == 3 ? parse(name[0], name[1], name[2], '\0') : SequenceId::INVALID) {}
+
+  /// The sequence of three elemental rotations about the given axes, if it is valid
+  static constexpr Sequence fromAxes(Axis first, Axis second, Axis third) {
+    return fromIndices(static_cast<int>(first), static_cast<int>(second), static_cast<int>(third));
+  }
+
+  constexpr SequenceId id() const { return id_; }
+
+  /// True if this is one of the 12 valid sequences
+  constexpr bool valid() const { return index() < static_cast<int>(SequenceId::INVALID); }
+
+  /// Axis of the i-th (0, 1 or 2) elemental rotation of a valid sequence
+  constexpr Axis axis(int i) const {
+    return static_cast<Axis>(i == 0 ? first(index()) : i == 1 ? second(index()) : third(index()));
+  }
+
+  /// True for a valid sequence that repeats its first axis (e.g., zxz)
+  constexpr bool proper() const { return valid() && index() >= 6; }
+
+  /// The sequence of the same axes in reverse order (e.g., xyz for zyx)
+  constexpr Sequence reversed() const {
+    return valid() ? fromAxes(axis(2), axis(1), axis(0)) : Sequence();
+  }
+
+  /// Name of the sequence (e.g., "zyx"), or an empty string if it is invalid
+  const char* name() const;
+
+  constexpr bool operator==(Sequence other) const { return id_ == other.id_; }
+  constexpr bool operator!=(Sequence other) const { return id_ != other.id_; }
+
+ private:
+  constexpr int index() const { return static_cast<int>(id_); }
+
+  /// Index (x = 0, y = 1, z = 2) of the axis named c, or -1
+  static constexpr int axisIndex(char c) { return c == 'x' ? 0 : c == 'y' ? 1 : c == 'z' ? 2 : -1; }
+
+  /// Parses a null-terminated name, reading no further than its terminator
+  static constexpr SequenceId parse(const char* name) {
+    return name[0] == '\0' || name[1] == '\0' || name[2] == '\0'
+               ? SequenceId::INVALID
+               : parse(name[0], name[1], name[2], name[3]);
+  }
+
+  static constexpr SequenceId parse(char a, char b, char c, char end) {
+    return end != '\0' ? SequenceId::INVALID
+                       : fromIndices(axisIndex(a), axisIndex(b), axisIndex(c)).id_;
+  }
+
+  // Sequences are ordered by first axis, and then by second axis for each kind of sequence
+  static constexpr Sequence fromIndices(int a, int b, int c) {
+    return a < 0 || b < 0 || c < 0 || a == b || b == c
+               ? Sequence()
+               : Sequence(static_cast<SequenceId>(a == c ? 6 + 2 * a + (b > 3 - a - b ? 1 : 0)
+                                                         : 2 * a + (b > c ? 1 : 0)));
+  }
+
+  static constexpr int first(int k) { return k % 6 / 2; }
+  static constexpr int other(int k, bool high) {
+    return high ? (first(k) == 2 ? 1 : 2) : (first(k) == 0 ? 1 : 0);
+  }
+  static constexpr int second(int k) { return other(k, k % 2 == 1); }
+  static constexpr int third(int k) { return k >= 6 ? first(k) : other(k, k % 2 == 0); }
+
+  SequenceId id_;
+};
+
+static_assert(sizeof(Sequence) == 1, "Sequences must take a single byte");
+
+/**
+ * @brief Distance (in radians) from gimbal lock within which toEulerAngles treats the middle angle
+ * as singular
+ */
+constexpr double GIMBAL_LOCK_TOLERANCE = 1e-8;
+
 /**
  * @brief Order of rotation
  */
@@ -32,11 +153,59 @@ enum class Direction { ACTIVE, PASSIVE };
  * @brief Fully describes the conventions used for a rotation
  **/
 struct Convention {
-  Convention(Order o, Direction d) : order(o), direction(d){};
-  const Order order;
-  const Direction direction;
+  constexpr Convention(Order o, Direction d) : order(o), direction(d) {}
+  Order order;
+  Direction direction;
 };
 
+/// Number of valid ConventionCodes, one per sequence, order and direction
+constexpr std::size_t CONVENTION_CODE_COUNT = 48;
+
+/**
+ * @brief A sequence and a convention packed into a single byte
+ *
+ * @details The value of a code is 4 * sequence id + 2 * passive + extrinsic, so the values from 0
+ * to 47 are valid (the same numbering as the seq and conv arguments of the C interface). Arrays of
+ * codes give every record of a batch its own sequence and convention.
+ */
+class ConventionCode {
+ public:
+  /// An invalid code
+  constexpr ConventionCode() : value_(CONVENTION_CODE_COUNT) {}
+
+  constexpr ConventionCode(Sequence sequence, Convention convention)
+      : value_(sequence.valid() ? 4 * static_cast<int>(sequence.id()) +
+                                      (convention.direction == Direction::PASSIVE ? 2 : 0) +
+                                      (convention.order == Order::EXTRINSIC ? 1 : 0)
+                                : CONVENTION_CODE_COUNT) {}
+
+  /// The code of a given value, which is invalid unless it is less than CONVENTION_CODE_COUNT
+  static constexpr ConventionCode fromValue(std::uint8_t value) { return ConventionCode(value); }
+
+  constexpr std::uint8_t value() const { return value_; }
+
+  constexpr bool valid() const { return value_ < CONVENTION_CODE_COUNT; }
+
+  constexpr Sequence sequence() const {
+    return valid() ? Sequence(static_cast<SequenceId>(value_ / 4)) : Sequence();
+  }
+
+  constexpr Convention convention() const {
+    return Convention(value_ & 1 ? Order::EXTRINSIC : Order::INTRINSIC,
+                      value_ & 2 ? Direction::PASSIVE : Direction::ACTIVE);
+  }
+
+  constexpr bool operator==(ConventionCode other) const { return value_ == other.value_; }
+  constexpr bool operator!=(ConventionCode other) const { return value_ != other.value_; }
+
+ private:
+  explicit constexpr ConventionCode(std::uint8_t value) : value_(value) {}
+
+  std::uint8_t value_;
+};
+
+static_assert(sizeof(ConventionCode) == 1, "Convention codes must take a single byte");
+
 /**
  * @brief Multiplication operation of two rotation matrices
  *
@@ -65,9 +234,62 @@ RotationMatrix transpose(const RotationMatrix& R);
  *
  * @return The resulting rotation matrix
  */
-RotationMatrix toRotationMatrix(const Sequence& sequence, const Angles& angles,
+RotationMatrix toRotationMatrix(Sequence sequence, const Angles& angles,
                                 Convention convention);
 
+/**
+ * @brief Converts a contiguous batch of euler angle sequences to rotation matrices
+ *
+ * @details The sequence and convention are resolved once for the whole batch, and sines and
+ * cosines are computed several angles at a time with euler::sincos, so this is considerably cheaper
+ * than calling the single conversion in a loop.
+ *
+ * @param[in] sequence The sequence of principal axes shared by every set of angles
+ * @param[in] angles Pointer to the first of count sets of Euler angles
+ * @param[in] count Number of sets of Euler angles to convert
+ * @param[in] convention The convention shared by every set of angles
+ * @param[out] out Pointer to storage for count rotation matrices (may not alias angles)
+ */
+void toRotationMatrix(Sequence sequence, const Angles* angles, std::size_t count,
+                      Convention convention, RotationMatrix* out);
+
+/**
+ * @brief Converts a contiguous batch of euler angle sequences, each with its own sequence and
+ * convention, to rotation matrices
+ *
+ * @details Sines and cosines are computed several angles at a time regardless of the codes, and
+ * each record is then evaluated with the kernel resolved in advance for its code, so batches of
+ * mixed conventions cost about the same as batches of a single one.
+ *
+ * @param[in] codes Pointer to the valid sequence and convention of each of count sets of angles
+ * @param[in] angles Pointer to the first of count sets of Euler angles
+ * @param[in] count Number of sets of Euler angles to convert
+ * @param[out] out Pointer to storage for count rotation matrices (may not alias angles)
+ */
+void toRotationMatrix(const ConventionCode* codes, const Angles* angles, std::size_t count,
+                      RotationMatrix* out);
+
+/**
+ * @brief Converts an euler angle sequence to a rotation matrix, with the sequence and convention
+ * fixed at compile time
+ *
+ * @details Equivalent to the runtime overload, but the kernel is selected statically so the call
+ * can be fully inlined, e.g., toRotationMatrix<Axis::Z, Axis::Y, Axis::X, Order::INTRINSIC,
+ * Direction::ACTIVE>(angles).
+ *
+ * @tparam A1 First axis of the sequence
+ * @tparam A2 Second axis of the sequence
+ * @tparam A3 Third axis of the sequence
+ * @tparam ORDER Order of the convention used to generate the rotation matrix
+ * @tparam DIRECTION Direction of the convention used to generate the rotation matrix
+ *
+ * @param[in] angles The three Euler angles in the same order as the sequence
+ *
+ * @return The resulting rotation matrix
+ */
+template <Axis A1, Axis A2, Axis A3, Order ORDER, Direction DIRECTION>
+RotationMatrix toRotationMatrix(const Angles& angles);
+
 /**
  * @brief Converts a rotation matrix (assumed to be orthonormal) to the unit quaternion that
  * parametizes the equivalent rotation
@@ -81,6 +303,108 @@ RotationMatrix toRotationMatrix(const Sequence& sequence, const Angles& angles,
  */
 Quaternion toQuaternion(const RotationMatrix& R);
 
+/**
+ * @brief Converts an euler angle sequence directly to a unit quaternion
+ *
+ * @details Composes the three elemental half-angle quaternions without forming a rotation matrix,
+ * which is cheaper and more accurate near rotations of 180 degrees. As with
+ * toQuaternion(const RotationMatrix&), the scalar part of the result is non-negative.
+ *
+ * @param[in] sequence The sequence of principal axes (e.g., xyz, zxz, etc.)
+ * @param[in] angles The three Euler angles in the same order as the sequence
+ * @param[in] convention The convention used to generate the rotation
+ *
+ * @return The resulting unit quaternion
+ */
+Quaternion toQuaternion(Sequence sequence, const Angles& angles, Convention convention);
+
+/**
+ * @brief Converts a contiguous batch of euler angle sequences directly to unit quaternions
+ *
+ * @details Sines and cosines are computed several angles at a time with euler::sincos.
+ *
+ * @param[in] sequence The sequence of principal axes shared by every set of angles
+ * @param[in] angles Pointer to the first of count sets of Euler angles
+ * @param[in] count Number of sets of Euler angles to convert
+ * @param[in] convention The convention shared by every set of angles
+ * @param[out] out Pointer to storage for count unit quaternions (may not alias angles)
+ */
+void toQuaternion(Sequence sequence, const Angles* angles, std::size_t count,
+                  Convention convention, Quaternion* out);
+
+/**
+ * @brief Converts a contiguous batch of euler angle sequences, each with its own sequence and
+ * convention, directly to unit quaternions
+ *
+ * @param[in] codes Pointer to the valid sequence and convention of each of count sets of angles
+ * @param[in] angles Pointer to the first of count sets of Euler angles
+ * @param[in] count Number of sets of Euler angles to convert
+ * @param[out] out Pointer to storage for count unit quaternions (may not alias angles)
+ */
+void toQuaternion(const ConventionCode* codes, const Angles* angles, std::size_t count,
+                  Quaternion* out);
+
+/**
+ * @brief Converts a rotation matrix (assumed to be orthonormal) to euler angles
+ *
+ * @details The first and third angles are in [-pi, pi]. The middle angle is in [-pi/2, pi/2] for
+ * sequences of three different axes (e.g., zyx) and in [0, pi] for sequences that repeat their
+ * first axis (e.g., zxz). Within GIMBAL_LOCK_TOLERANCE of gimbal lock, where only the sum or
+ * difference of the first and third angles is defined, the third angle is set to zero and the first
+ * angle carries the whole rotation about those axes.
+ *
+ * @param[in] R Rotation matrix to convert
+ * @param[in] sequence The sequence of principal axes (e.g., xyz, zxz, etc.)
+ * @param[in] convention The convention used to generate the rotation matrix
+ *
+ * @return The three Euler angles in the same order as the sequence
+ */
+Angles toEulerAngles(const RotationMatrix& R, Sequence sequence, Convention convention);
+
+/**
+ * @brief Converts a unit quaternion to euler angles
+ *
+ * @details Works directly on the quaternion without forming a rotation matrix. The ranges of the
+ * angles and the handling of gimbal lock are the same as for the rotation matrix overload.
+ *
+ * @param[in] q Unit quaternion to convert (q and -q give the same angles)
+ * @param[in] sequence The sequence of principal axes (e.g., xyz, zxz, etc.)
+ * @param[in] convention The convention used to generate the rotation
+ *
+ * @return The three Euler angles in the same order as the sequence
+ */
+Angles toEulerAngles(const Quaternion& q, Sequence sequence, Convention convention);
+
+/**
+ * @brief Converts a contiguous batch of rotation matrices to euler angles
+ *
+ * @param[in] R Pointer to the first of count rotation matrices
+ * @param[in] count Number of rotation matrices to convert
+ * @param[in] sequence The sequence of principal axes shared by every rotation
+ * @param[in] convention The convention shared by every rotation
+ * @param[out] out Pointer to storage for count sets of Euler angles
+ */
+void toEulerAngles(const RotationMatrix* R, std::size_t count, Sequence sequence,
+                   Convention convention, Angles* out);
+
+/**
+ * @brief Converts a contiguous batch of unit quaternions to euler angles
+ *
+ * @param[in] q Pointer to the first of count unit quaternions
+ * @param[in] count Number of unit quaternions to convert
+ * @param[in] sequence The sequence of principal axes shared by every rotation
+ * @param[in] convention The convention shared by every rotation
+ * @param[out] out Pointer to storage for count sets of Euler angles
+ */
+void toEulerAngles(const Quaternion* q, std::size_t count, Sequence sequence,
+                   Convention convention, Angles* out);
+
 }  // namespace euler
 
+#include <euler/kernels.h>
+
+#if EULER_INLINE_KERNELS
+#include <euler/rotations_impl.h>
+#endif
+
 #endif
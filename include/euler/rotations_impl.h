@@ -0,0 +1,191 @@
+#ifndef EULER_ROTATIONS_IMPL_H
+#define EULER_ROTATIONS_IMPL_H
+
+#include <euler/rotations.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+// Definitions of the single conversions and the matrix operations. With EULER_INLINE_KERNELS set
+// to 1, rotations.h includes this file and the functions are inline, so calls in tight loops are
+// inlined and, when the sequence and convention are constants, resolved at compile time.
+// Otherwise only rotations.cpp includes it and the library holds the only definitions.
+
+#if EULER_INLINE_KERNELS
+#define EULER_INLINE inline
+#else
+#define EULER_INLINE
+#endif
+
+namespace euler {
+namespace kernels {
+
+/// Closed-form active, intrinsic rotation matrix for one sequence, R_1(a_1) * R_2(a_2) * R_3(a_3)
+using Kernel = RotationMatrix (*)(const Trig& t);
+
+inline Kernel kernel(Sequence sequence) {
+  // clang-format off
+  static const std::array<Kernel, 12> table = {{
+      R_active<Axis::X, Axis::Y, Axis::Z>,
+      R_active<Axis::X, Axis::Z, Axis::Y>,
+      R_active<Axis::Y, Axis::X, Axis::Z>,
+      R_active<Axis::Y, Axis::Z, Axis::X>,
+      R_active<Axis::Z, Axis::X, Axis::Y>,
+      R_active<Axis::Z, Axis::Y, Axis::X>,
+      R_active<Axis::X, Axis::Y, Axis::X>,
+      R_active<Axis::X, Axis::Z, Axis::X>,
+      R_active<Axis::Y, Axis::X, Axis::Y>,
+      R_active<Axis::Y, Axis::Z, Axis::Y>,
+      R_active<Axis::Z, Axis::X, Axis::Z>,
+      R_active<Axis::Z, Axis::Y, Axis::Z>}};
+  // clang-format on
+  assert(sequence.valid() && "invalid rotation sequence");
+  return table[static_cast<std::size_t>(sequence.id())];
+}
+
+/**
+ * @brief A sequence and convention resolved to one closed-form kernel
+ *
+ * @details Every convention reduces to an active, intrinsic kernel:
+ *   - extrinsic ijk (a, b, c) is intrinsic kji (c, b, a)
+ *   - passive intrinsic ijk (a, b, c) is R^T = intrinsic kji (-c, -b, -a)
+ *   - passive extrinsic ijk (a, b, c) is intrinsic ijk (-a, -b, -c)
+ * Negating an angle only negates its sine, so no transpose is ever needed.
+ */
+struct Dispatch {
+  Kernel kernel;
+  std::array<int, 3> axes;  ///< Indices (x = 0, y = 1, z = 2) of the kernel's axes
+  bool reverse;             ///< Apply the angles in reverse order
+  double sign;              ///< Sign applied to the sines of the angles
+};
+
+inline Dispatch resolve(Sequence sequence, Convention convention) {
+  const bool intrinsic = convention.order == Order::INTRINSIC;
+  const bool active = convention.direction == Direction::ACTIVE;
+  const bool reverse = intrinsic != active;
+
+  Dispatch d;
+  const Sequence applied = reverse ? sequence.reversed() : sequence;
+  d.kernel = kernel(applied);
+  for (int i = 0; i < 3; ++i) {
+    d.axes[i] = static_cast<int>(applied.axis(i));
+  }
+  d.reverse = reverse;
+  d.sign = active ? 1.0 : -1.0;
+  return d;
+}
+
+/**
+ * @brief Arranges the sines and cosines of one set of angles in the order of its kernel
+ *
+ * @param[in] d Resolved sequence and convention
+ * @param[in] s Sines of the three angles, in the same order as the sequence
+ * @param[in] c Cosines of the three angles, in the same order as the sequence
+ */
+inline Trig arrange(const Dispatch& d, const double* s, const double* c) {
+  const int first = d.reverse ? 2 : 0;
+  const int third = 2 - first;
+  return {c[first], d.sign * s[first], c[1], d.sign * s[1], c[third], d.sign * s[third]};
+}
+
+/// Sines and cosines of a single set of angles scaled by a factor, arranged for its kernel
+inline Trig trig(const Dispatch& d, const Angles& angles, double scale) {
+  std::array<double, 3> s, c;
+  for (int i = 0; i < 3; ++i) {
+    s[i] = std::sin(scale * angles[i]);
+    c[i] = std::cos(scale * angles[i]);
+  }
+  return arrange(d, s.data(), c.data());
+}
+
+inline RotationMatrix evaluate(const Dispatch& d, const Trig& t) {
+  return positiveZeros(d.kernel(t));
+}
+
+/// Composes the elemental quaternions for the half angles in t
+inline Quaternion evaluateQuaternion(const Dispatch& d, const Trig& t) {
+  const int i = d.axes[0];
+  const int j = d.axes[1];
+  const int k = d.axes[2];
+
+  // p = q_i(a1) * q_j(a2), where e_i x e_j = parity * e_m for the remaining axis m
+  const int m = 3 - i - j;
+  const double parity = (j == (i + 1) % 3) ? 1.0 : -1.0;
+  double p_w = t.c1 * t.c2;
+  std::array<double, 3> p_v;
+  p_v[i] = t.s1 * t.c2;
+  p_v[j] = t.c1 * t.s2;
+  p_v[m] = parity * t.s1 * t.s2;
+
+  // q = p * q_k(a3) = (p_w c3 - p_k s3, p_w s3 e_k + c3 p_v + s3 (p_v x e_k))
+  const int k1 = (k + 1) % 3;
+  const int k2 = (k + 2) % 3;
+  Quaternion q;
+  q[0] = p_w * t.c3 - p_v[k] * t.s3;
+  q[1 + k] = p_w * t.s3 + p_v[k] * t.c3;
+  q[1 + k1] = p_v[k1] * t.c3 + p_v[k2] * t.s3;
+  q[1 + k2] = p_v[k2] * t.c3 - p_v[k1] * t.s3;
+
+  // Match toQuaternion(const RotationMatrix&), which always has a non-negative scalar part
+  const double sign = q[0] < 0.0 ? -1.0 : 1.0;
+  for (auto& e : q) {
+    e = sign * e + 0.0;
+  }
+  return q;
+}
+
+}  // namespace kernels
+
+EULER_INLINE RotationMatrix operator*(const RotationMatrix& lhs, const RotationMatrix& rhs) {
+  return {lhs[0] * rhs[0] + lhs[1] * rhs[3] + lhs[2] * rhs[6],
+          lhs[0] * rhs[1] + lhs[1] * rhs[4] + lhs[2] * rhs[7],
+          lhs[0] * rhs[2] + lhs[1] * rhs[5] + lhs[2] * rhs[8],
+          lhs[3] * rhs[0] + lhs[4] * rhs[3] + lhs[5] * rhs[6],
+          lhs[3] * rhs[1] + lhs[4] * rhs[4] + lhs[5] * rhs[7],
+          lhs[3] * rhs[2] + lhs[4] * rhs[5] + lhs[5] * rhs[8],
+          lhs[6] * rhs[0] + lhs[7] * rhs[3] + lhs[8] * rhs[6],
+          lhs[6] * rhs[1] + lhs[7] * rhs[4] + lhs[8] * rhs[7],
+          lhs[6] * rhs[2] + lhs[7] * rhs[5] + lhs[8] * rhs[8]};
+}
+
+EULER_INLINE RotationMatrix transpose(const RotationMatrix& R) {
+  // clang-format off
+  return {R[0], R[3], R[6],
+          R[1], R[4], R[7],
+          R[2], R[5], R[8]};
+  // clang-format on
+}
+
+EULER_INLINE RotationMatrix toRotationMatrix(Sequence sequence, const Angles& angles,
+                                             Convention convention) {
+  const kernels::Dispatch d = kernels::resolve(sequence, convention);
+  return kernels::evaluate(d, kernels::trig(d, angles, 1.0));
+}
+
+EULER_INLINE Quaternion toQuaternion(Sequence sequence, const Angles& angles,
+                                     Convention convention) {
+  const kernels::Dispatch d = kernels::resolve(sequence, convention);
+  return kernels::evaluateQuaternion(d, kernels::trig(d, angles, 0.5));
+}
+
+EULER_INLINE Quaternion toQuaternion(const RotationMatrix& R) {
+  Quaternion q;
+  q[0] = std::sqrt(std::max(0.0, 1.0 + R[0] + R[4] + R[8])) / 2.0;
+
+  q[1] = std::sqrt(std::max(0.0, 1.0 + R[0] - R[4] - R[8])) / 2.0;
+  q[1] = std::copysign(q[1], R[7] - R[5]);
+
+  q[2] = std::sqrt(std::max(0.0, 1.0 - R[0] + R[4] - R[8])) / 2.0;
+  q[2] = std::copysign(q[2], R[2] - R[6]);
+
+  q[3] = std::sqrt(std::max(0.0, 1.0 - R[0] - R[4] + R[8])) / 2.0;
+  q[3] = std::copysign(q[3], R[3] - R[1]);
+  return q;
+}
+
+}  // namespace euler
+
+#undef EULER_INLINE
+
+#endif
@@ -0,0 +1,186 @@
+#ifndef EULER_SERVER_H
+#define EULER_SERVER_H
+
+#include <euler/parallel.h>
+#include <euler/rotations.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace euler {
+
+/**
+ * @brief Binary protocol spoken over the Unix domain socket of a Server
+ *
+ * @details A client sends requests and the server answers each with one response, in order. A
+ * request is a RequestHeader followed by count sets of three float64 angles (24 bytes each). A
+ * response is a ResponseHeader followed, when its status is OK, by count results: the nine
+ * float64 elements of the rotation matrix in row-major order if OUTPUT_MATRIX was requested, then
+ * the four float64 elements of the quaternion (w, x, y, z) if OUTPUT_QUATERNION was requested. All
+ * values are in the native byte order of the host. A client may send any number of requests
+ * before reading the responses; the server answers every complete request it has received, one
+ * after the other, and sends the responses back together.
+ */
+namespace protocol {
+
+/// First four bytes of every header ("EULR" in memory)
+constexpr std::uint32_t MAGIC = 0x524c5545;
+
+/// Version of the protocol described here
+constexpr std::uint8_t VERSION = 1;
+
+/// Largest number of sets of angles in one request
+constexpr std::uint32_t MAX_COUNT = 1 << 20;
+
+/// Bits of RequestHeader::outputs
+constexpr std::uint8_t OUTPUT_MATRIX = 1;
+constexpr std::uint8_t OUTPUT_QUATERNION = 2;
+
+/// Bits of RequestHeader::flags
+constexpr std::uint8_t FLAG_DEGREES = 1;  ///< Angles are in degrees rather than radians
+
+/**
+ * @brief Outcome of a request
+ */
+enum class Status : std::uint8_t {
+  OK = 0,                ///< Results follow the response header
+  INVALID_HEADER = 1,    ///< Wrong magic number or version; the server closes the connection
+  INVALID_SEQUENCE = 2,  ///< The sequence is not one of the 12 valid sequences
+  INVALID_OUTPUTS = 3,   ///< No outputs, or unknown bits, were requested
+  TOO_LARGE = 4          ///< count exceeds MAX_COUNT; the server closes the connection
+};
+
+struct RequestHeader {
+  std::uint32_t magic = MAGIC;
+  std::uint8_t version = VERSION;
+  char sequence[3];             ///< Axes of the sequence, e.g. {'z', 'y', 'x'}
+  std::uint8_t order;           ///< 0 for intrinsic, 1 for extrinsic
+  std::uint8_t direction;       ///< 0 for active, 1 for passive
+  std::uint8_t outputs;         ///< OUTPUT_MATRIX and/or OUTPUT_QUATERNION
+  std::uint8_t flags = 0;       ///< FLAG_DEGREES or 0
+  std::uint32_t count;          ///< Number of sets of angles that follow
+};
+
+struct ResponseHeader {
+  std::uint32_t magic = MAGIC;
+  std::uint8_t version = VERSION;
+  Status status;
+  std::uint8_t outputs;         ///< Outputs of the request
+  std::uint8_t reserved = 0;
+  std::uint32_t count;          ///< Number of results that follow (0 unless status is OK)
+  std::uint32_t reserved2 = 0;
+};
+
+static_assert(sizeof(RequestHeader) == 16, "Request headers must not be padded");
+static_assert(sizeof(ResponseHeader) == 16, "Response headers must not be padded");
+
+/**
+ * @brief Returns the number of bytes of one result for the given outputs
+ */
+constexpr std::size_t resultSize(std::uint8_t outputs) {
+  return ((outputs & OUTPUT_MATRIX) ? sizeof(RotationMatrix) : 0) +
+         ((outputs & OUTPUT_QUATERNION) ? sizeof(Quaternion) : 0);
+}
+
+}  // namespace protocol
+
+/**
+ * @brief A resident conversion server listening on a Unix domain socket
+ *
+ * @details A single thread multiplexes all connections with poll. Every request that has arrived
+ * on a connection is converted with the batch kernels on the threads of a pool, and all of the
+ * responses are sent together.
+ */
+class Server {
+ public:
+  /**
+   * @param[in] pool Threads for the conversion of large requests
+   */
+  explicit Server(ThreadPool& pool);
+  Server(const Server&) = delete;
+  Server& operator=(const Server&) = delete;
+  ~Server();
+
+  /**
+   * @brief Creates the socket, replacing any stale socket file at path, and starts listening
+   *
+   * @details A file at path is only replaced if it is a socket that no server is listening on, so
+   * neither regular files nor the sockets of running servers are ever removed.
+   *
+   * @param[in] path Path of the socket
+   *
+   * @return True on success, false if the socket cannot be created or path is in use
+   */
+  bool listen(const std::string& path);
+
+  /**
+   * @brief Serves connections until stop is called, then closes them and removes the socket file
+   */
+  void run();
+
+  /**
+   * @brief Makes run return; safe to call from other threads and from signal handlers
+   */
+  void stop();
+
+ private:
+  struct Connection;
+  bool receive(Connection& connection);
+  bool send(Connection& connection);
+
+  ThreadPool& pool_;
+  std::string path_;
+  int listener_ = -1;
+  int wake_[2] = {-1, -1};
+  std::vector<Connection*> connections_;
+};
+
+/**
+ * @brief A connection to a Server
+ */
+class Client {
+ public:
+  Client() = default;
+  Client(const Client&) = delete;
+  Client& operator=(const Client&) = delete;
+  ~Client();
+
+  /**
+   * @brief Connects to the server listening at path
+   *
+   * @return True on success, false if the server cannot be reached
+   */
+  bool connect(const std::string& path);
+
+  /**
+   * @brief Closes the connection
+   */
+  void close();
+
+  /**
+   * @brief Converts a batch of Euler angles in radians with one round trip to the server
+   *
+   * @param[in] sequence Rotation sequence of all angles
+   * @param[in] angles Pointer to the first of count sets of angles
+   * @param[in] count Number of sets of angles (at most protocol::MAX_COUNT)
+   * @param[in] convention Rotation convention of all angles
+   * @param[out] R Pointer to storage for count rotation matrices, or null if they are not needed
+   * @param[out] q Pointer to storage for count quaternions, or null if they are not needed
+   *
+   * @return Status of the response; protocol::Status::INVALID_HEADER also when the connection
+   * fails, and protocol::Status::TOO_LARGE, without sending anything, when count exceeds
+   * protocol::MAX_COUNT
+   */
+  protocol::Status convert(Sequence sequence, const Angles* angles, std::size_t count,
+                           Convention convention, RotationMatrix* R, Quaternion* q);
+
+ private:
+  int socket_ = -1;
+  std::vector<char> buffer_;
+};
+
+}  // namespace euler
+
+#endif
@@ -0,0 +1,161 @@
+#ifndef EULER_SHM_H
+#define EULER_SHM_H
+
+#include <euler/binary.h>
+#include <euler/rotations.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace euler {
+
+/**
+ * @brief Outcome of a request made through a SharedRing
+ */
+enum class SharedStatus : std::uint8_t {
+  PENDING = 0,            ///< The worker has not converted the request yet
+  OK = 1,                 ///< The rotation matrix and quaternion hold the result
+  INVALID_CONVENTION = 2  ///< The sequence is not one of the 12 valid sequences
+};
+
+/**
+ * @brief A ring of request slots in shared memory between producer processes and one worker
+ *
+ * @details The ring lives in a file that every process maps, ideally on a memory file system such
+ * as /dev/shm. A producer claims the next free slot, writes a set of angles in radians with its
+ * sequence and convention, and gets a ticket; the worker converts every ready slot in order with
+ * the batch kernels, whatever the sequences and conventions of the requests, and writes the
+ * rotation matrix and quaternion back into the slot; the producer collects the result with its
+ * ticket, which frees the slot. Slots are claimed with a compare-and-swap, so any number of
+ * threads and processes may produce at once (a single producer never retries). No call takes a
+ * lock, and a request that finds its slot ready makes no system call; calls that wait spin,
+ * calling sched_yield between checks.
+ *
+ * Every ticket must be collected exactly once, since its slot is only reused afterwards.
+ */
+class SharedRing {
+ public:
+  SharedRing() = default;
+  SharedRing(const SharedRing&) = delete;
+  SharedRing& operator=(const SharedRing&) = delete;
+  ~SharedRing();
+
+  /**
+   * @brief Creates a ring file and maps it (worker)
+   *
+   * @details A file already at path is only replaced if it holds a ring, such as one left behind
+   * by a worker that was killed; any other file is left untouched.
+   *
+   * @param[in] path Path of the file
+   * @param[in] capacity Minimum number of slots (rounded up to a power of two of at least 4)
+   *
+   * @return True on success, false if the file cannot be created or mapped, or path holds a file
+   * that is not a ring
+   */
+  bool create(const std::string& path, std::size_t capacity);
+
+  /**
+   * @brief Maps a ring file created by a worker (producers)
+   *
+   * @param[in] path Path of the file
+   *
+   * @return True on success, false if the file cannot be mapped or does not hold a ring
+   */
+  bool open(const std::string& path);
+
+  /**
+   * @brief Unmaps the ring, if open; the file itself is left in place
+   */
+  void close();
+
+  bool isOpen() const { return slots_ != nullptr; }
+
+  /// Number of slots, i.e., the maximum number of uncollected requests
+  std::size_t capacity() const { return isOpen() ? mask_ + 1 : 0; }
+
+  /**
+   * @brief Submits a set of angles if a slot is free (producers)
+   *
+   * @param[in] sequence Rotation sequence of the angles
+   * @param[in] angles Euler angles in radians
+   * @param[in] convention Rotation convention of the angles
+   * @param[out] ticket Ticket with which to collect the result
+   *
+   * @return True if the request was submitted, false if every slot is taken
+   */
+  bool trySubmit(Sequence sequence, const Angles& angles, Convention convention,
+                 std::uint64_t& ticket);
+
+  /**
+   * @brief Submits a set of angles, waiting while every slot is taken (producers)
+   *
+   * @return Ticket with which to collect the result
+   */
+  std::uint64_t submit(Sequence sequence, const Angles& angles, Convention convention);
+
+  /**
+   * @brief Collects the result of a request if the worker has converted it (producers)
+   *
+   * @param[in] ticket Ticket returned when the request was submitted
+   * @param[out] R Rotation matrix of the request, set if the status is OK
+   * @param[out] q Unit quaternion of the request, set if the status is OK
+   *
+   * @return Status of the request; the slot is freed unless it is PENDING
+   */
+  SharedStatus tryCollect(std::uint64_t ticket, RotationMatrix& R, Quaternion& q);
+
+  /**
+   * @brief Collects the result of a request, waiting for the worker to convert it (producers)
+   *
+   * @return Status of the request, never PENDING
+   */
+  SharedStatus collect(std::uint64_t ticket, RotationMatrix& R, Quaternion& q);
+
+  /**
+   * @brief Converts a set of angles with one round trip through the ring (producers)
+   */
+  SharedStatus convert(Sequence sequence, const Angles& angles, Convention convention,
+                       RotationMatrix& R, Quaternion& q);
+
+  /**
+   * @brief Converts every request that is ready (worker)
+   *
+   * @return Number of requests converted
+   */
+  std::size_t process();
+
+  /**
+   * @brief Converts requests as they arrive until stop is called (worker)
+   *
+   * @details The worker polls the ring, so it keeps one processor busy while it runs.
+   */
+  void run();
+
+  /**
+   * @brief Makes run return; safe to call from other threads and from signal handlers
+   */
+  void stop() { stopped_.store(true, std::memory_order_release); }
+
+ private:
+  struct Header;
+  struct Slot;
+
+  MappedFile file_;
+  Header* header_ = nullptr;
+  Slot* slots_ = nullptr;
+  std::size_t mask_ = 0;
+  std::atomic<bool> stopped_{false};
+
+  // Scratch space of the worker for the requests it converts together
+  std::vector<Angles> angles_;
+  std::vector<ConventionCode> codes_;
+  std::vector<RotationMatrix> R_;
+  std::vector<Quaternion> q_;
+};
+
+}  // namespace euler
+
+#endif
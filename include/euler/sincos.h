@@ -0,0 +1,72 @@
+#ifndef EULER_SINCOS_H
+#define EULER_SINCOS_H
+
+#include <cstddef>
+
+namespace euler {
+
+/// Largest magnitude of angle (in radians) reduced by the vectorized kernel; larger or non-finite
+/// angles are delegated to std::sin and std::cos
+constexpr double SINCOS_MAX_REDUCED_ANGLE = 1048576.0;
+
+/// Maximum error, in units in the last place, of sincos relative to std::sin and std::cos
+constexpr int SINCOS_MAX_ULP_ERROR = 1;
+
+/**
+ * @brief Instruction set used by the vectorized kernels, from slowest to fastest
+ */
+enum class SimdLevel {
+  SCALAR,    ///< One angle at a time with std::sin and std::cos
+  BASELINE,  ///< Two lanes available on every target of GCC and Clang (SSE2 on x86-64)
+  AVX2,      ///< Four lanes with AVX2 and FMA
+  AVX512     ///< Eight lanes with AVX-512F
+};
+
+/**
+ * @brief Returns the fastest instruction set supported by both the build and the running CPU
+ *
+ * @details Detected once, on first use, from CPUID.
+ */
+SimdLevel supportedSimdLevel();
+
+/**
+ * @brief Returns the instruction set used by sincos and the batch conversions
+ *
+ * @details This is supportedSimdLevel(), unless the EULER_SIMD environment variable names a slower
+ * level (scalar, baseline, avx2 or avx512) when the process first uses it.
+ */
+SimdLevel simdLevel();
+
+/**
+ * @brief Computes the sine and cosine of a contiguous batch of angles
+ *
+ * @details Processes several angles per instruction using the SIMD lanes of simdLevel(). Angles
+ * are reduced modulo pi/2 with a three-part Cody-Waite reduction carried in double-double
+ * precision and evaluated with the fdlibm minimax polynomials. For every angle with magnitude up
+ * to SINCOS_MAX_REDUCED_ANGLE the results are within SINCOS_MAX_ULP_ERROR units in the last place
+ * of std::sin and std::cos; all other angles use std::sin and std::cos directly.
+ *
+ * @param[in] angles Pointer to the first of count angles in radians
+ * @param[in] count Number of angles
+ * @param[out] sines Pointer to storage for count sines (may not alias angles)
+ * @param[out] cosines Pointer to storage for count cosines (may not alias angles or sines)
+ */
+void sincos(const double* angles, std::size_t count, double* sines, double* cosines);
+
+/**
+ * @brief Computes the sine and cosine of a contiguous batch of angles with a given instruction set
+ *
+ * @details As above, with an explicit level that must not exceed supportedSimdLevel().
+ *
+ * @param[in] angles Pointer to the first of count angles in radians
+ * @param[in] count Number of angles
+ * @param[out] sines Pointer to storage for count sines (may not alias angles)
+ * @param[out] cosines Pointer to storage for count cosines (may not alias angles or sines)
+ * @param[in] level Instruction set to use
+ */
+void sincos(const double* angles, std::size_t count, double* sines, double* cosines,
+            SimdLevel level);
+
+}  // namespace euler
+
+#endif
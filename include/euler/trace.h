@@ -0,0 +1,95 @@
+#ifndef EULER_TRACE_H
+#define EULER_TRACE_H
+
+#include <euler/instrument.h>
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace euler {
+
+/**
+ * @brief Starts recording trace events, discarding any recorded before
+ *
+ * @details Once started, the probes of euler/instrument.h, the chunks of ThreadPool::parallelFor
+ * and the stages of the CLI record one event each time they run, on the thread that runs them.
+ * Each thread appends to its own buffer without locks. Events are written by writeTrace in the
+ * Trace Event Format of chrome://tracing and Perfetto. Nothing is recorded if the instrumentation
+ * is compiled out.
+ *
+ * startTrace, stopTrace and writeTrace must not be called while other threads record events.
+ */
+void startTrace();
+
+/**
+ * @brief Stops recording trace events, keeping those recorded
+ */
+void stopTrace();
+
+/**
+ * @brief Determines if trace events are being recorded
+ */
+bool tracing();
+
+/**
+ * @brief Names the calling thread in traces (e.g. "parse" or "pool 3")
+ */
+void setTraceThreadName(const std::string& name);
+
+/**
+ * @brief Records an event of the calling thread that ran from start to end, if tracing
+ *
+ * @param[in] name Name of the event, which must have static storage duration (e.g. a literal)
+ * @param[in] category Category of the event, which must have static storage duration
+ * @param[in] start Time the event started
+ * @param[in] end Time the event ended
+ * @param[in] records Number of records processed, shown with the event unless zero
+ */
+void traceEvent(const char* name, const char* category, std::chrono::steady_clock::time_point start,
+                std::chrono::steady_clock::time_point end, std::size_t records);
+
+/**
+ * @brief Writes the events recorded since startTrace as a JSON trace file
+ *
+ * @return False if the file cannot be written
+ */
+bool writeTrace(const std::string& path);
+
+/**
+ * @brief Records an event spanning a scope, if tracing when the scope is entered
+ */
+class TraceScope {
+ public:
+#if EULER_INSTRUMENTATION
+  TraceScope(const char* name, const char* category, std::size_t records = 0)
+      : name_(tracing() ? name : nullptr), category_(category), records_(records) {
+    if (name_ != nullptr) {
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  ~TraceScope() {
+    if (name_ != nullptr) {
+      traceEvent(name_, category_, start_, std::chrono::steady_clock::now(), records_);
+    }
+  }
+#else
+  TraceScope(const char*, const char*, std::size_t = 0) {}
+#endif
+
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+
+#if EULER_INSTRUMENTATION
+ private:
+  const char* name_;
+  const char* category_;
+  std::size_t records_;
+  std::chrono::steady_clock::time_point start_;
+#endif
+};
+
+}  // namespace euler
+
+#endif
@@ -0,0 +1,44 @@
+# Training workload of the profile-guided build, run by the pgo-train target with cmake -P
+#
+# Runs the instrumented euler over the bundled corpus of 4096 sets of angles for every sequence
+# and convention, with text input (degrees) and binary input (radians, both memory-mapped and
+# streamed), converts single angles given on the command line, and runs a short pass of
+# euler_bench for the library calls the CLI does not make. With Clang, the raw profiles are then
+# merged into the profile read by the optimized build.
+#
+# Variables: EULER, EULER_BENCH, CORPUS_DIR, PROFILE_DIR, COMPILER_ID and, for Clang,
+# LLVM_PROFDATA.
+
+set(sequences xyz xzy yxz yzx zxy zyx xyx xzx yxy yzy zxz zyz)
+set(conventions "" -e -p -ep)
+set(output "${PROFILE_DIR}/output")
+
+function(run)
+  execute_process(COMMAND ${ARGN} RESULT_VARIABLE result OUTPUT_QUIET)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "Training run failed (${result}): ${ARGN}")
+  endif()
+endfunction()
+
+foreach(sequence ${sequences})
+  foreach(convention ${conventions})
+    run(${EULER} ${convention} -s ${sequence} -i ${CORPUS_DIR}/angles.txt -o ${output})
+    run(${EULER} -r ${convention} -s ${sequence} -b -i ${CORPUS_DIR}/angles.bin -o ${output})
+    run(${EULER} ${convention} -s ${sequence} -- 20 -10 35)
+  endforeach()
+  execute_process(COMMAND ${EULER} -r -s ${sequence} -b -i -
+                  INPUT_FILE ${CORPUS_DIR}/angles.bin OUTPUT_FILE ${output} RESULT_VARIABLE result)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "Training run failed (${result}): streamed binary input")
+  endif()
+endforeach()
+file(REMOVE ${output})
+
+if(EULER_BENCH)
+  run(${EULER_BENCH} --min-time 0.005 --repetitions 1 --no-counters)
+endif()
+
+if(COMPILER_ID STREQUAL "Clang")
+  file(GLOB raw_profiles "${PROFILE_DIR}/*.profraw")
+  run(${LLVM_PROFDATA} merge -output=${PROFILE_DIR}/euler.profdata ${raw_profiles})
+endif()
@@ -0,0 +1,130 @@
+#include <euler/binary.h>
+
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace euler {
+namespace {  // anonymous
+
+static_assert(sizeof(BinaryRecord) == 13 * sizeof(double), "Binary records must not be padded");
+
+/// Number of records converted at a time before being interleaved into the output
+const std::size_t RECORD_BLOCK_SIZE = 256;
+
+}  // namespace
+
+void toBinaryRecords(Sequence sequence, const Angles* angles, std::size_t count,
+                     Convention convention, BinaryRecord* out) {
+  std::array<RotationMatrix, RECORD_BLOCK_SIZE> R;
+  std::array<Quaternion, RECORD_BLOCK_SIZE> q;
+  for (std::size_t begin = 0; begin < count; begin += RECORD_BLOCK_SIZE) {
+    const std::size_t n = std::min(RECORD_BLOCK_SIZE, count - begin);
+    toRotationMatrix(sequence, angles + begin, n, convention, R.data());
+    toQuaternion(sequence, angles + begin, n, convention, q.data());
+    for (std::size_t i = 0; i < n; ++i) {
+      out[begin + i].R = R[i];
+      out[begin + i].q = q[i];
+    }
+  }
+}
+
+MappedFile::MappedFile(MappedFile&& other)
+    : fd_(other.fd_), data_(other.data_), size_(other.size_) {
+  other.fd_ = -1;
+  other.data_ = nullptr;
+  other.size_ = 0;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) {
+  if (this != &other) {
+    close();
+    std::swap(fd_, other.fd_);
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+  }
+  return *this;
+}
+
+MappedFile::~MappedFile() { close(); }
+
+bool MappedFile::openRead(const std::string& path) {
+  close();
+  fd_ = ::open(path.c_str(), O_RDONLY);
+  struct stat status;
+  if (fd_ == -1 || ::fstat(fd_, &status) != 0 || !S_ISREG(status.st_mode)) {
+    close();
+    return false;
+  }
+
+  size_ = status.st_size;
+  if (size_ > 0) {
+    void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (data == MAP_FAILED) {
+      close();
+      return false;
+    }
+    data_ = static_cast<char*>(data);
+    ::madvise(data, size_, MADV_SEQUENTIAL);
+  }
+  return true;
+}
+
+bool MappedFile::create(const std::string& path, std::size_t size, bool exclusive) {
+  close();
+  fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | (exclusive ? O_EXCL : O_TRUNC), 0666);
+  if (fd_ == -1 || (size > 0 && ::posix_fallocate(fd_, 0, size) != 0)) {
+    close();
+    return false;
+  }
+
+  size_ = size;
+  if (size_ > 0) {
+    void* data = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (data == MAP_FAILED) {
+      close();
+      return false;
+    }
+    data_ = static_cast<char*>(data);
+  }
+  return true;
+}
+
+bool MappedFile::sync() { return data_ == nullptr || ::msync(data_, size_, MS_SYNC) == 0; }
+
+bool MappedFile::openShared(const std::string& path) {
+  close();
+  fd_ = ::open(path.c_str(), O_RDWR);
+  struct stat status;
+  if (fd_ == -1 || ::fstat(fd_, &status) != 0 || !S_ISREG(status.st_mode)) {
+    close();
+    return false;
+  }
+
+  size_ = status.st_size;
+  if (size_ > 0) {
+    void* data = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (data == MAP_FAILED) {
+      close();
+      return false;
+    }
+    data_ = static_cast<char*>(data);
+  }
+  return true;
+}
+
+void MappedFile::close() {
+  if (data_ != nullptr) {
+    ::munmap(data_, size_);
+  }
+  if (fd_ != -1) {
+    ::close(fd_);
+  }
+  fd_ = -1;
+  data_ = nullptr;
+  size_ = 0;
+}
+
+}  // namespace euler
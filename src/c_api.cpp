@@ -0,0 +1,105 @@
+#include <euler/c_api.h>
+
+#include <euler/rotations.h>
+
+using namespace euler;
+
+namespace {  // anonymous
+
+static_assert(sizeof(Angles) == 3 * sizeof(double), "Angles must be flat arrays of doubles");
+static_assert(sizeof(RotationMatrix) == 9 * sizeof(double), "Matrices must be flat arrays");
+static_assert(sizeof(Quaternion) == 4 * sizeof(double), "Quaternions must be flat arrays");
+static_assert(EULER_XYZ == static_cast<int>(SequenceId::XYZ) &&
+                  EULER_ZYX == static_cast<int>(SequenceId::ZYX) &&
+                  EULER_XYX == static_cast<int>(SequenceId::XYX) &&
+                  EULER_ZYZ == static_cast<int>(SequenceId::ZYZ),
+              "C sequences must be numbered as SequenceId");
+
+/**
+ * @brief Checks the arguments shared by every conversion
+ *
+ * @return EULER_OK, or the euler_status of the first invalid argument
+ */
+int check(const void* in, std::size_t n, int seq, int conv, const void* out) {
+  if (seq < 0 || seq >= static_cast<int>(SequenceId::INVALID)) {
+    return EULER_INVALID_SEQUENCE;
+  }
+  if ((conv & ~(EULER_EXTRINSIC | EULER_PASSIVE)) != 0) {
+    return EULER_INVALID_CONVENTION;
+  }
+  if (n != 0 && (in == nullptr || out == nullptr)) {
+    return EULER_INVALID_POINTER;
+  }
+  return EULER_OK;
+}
+
+Sequence toSequence(int seq) { return static_cast<SequenceId>(seq); }
+
+Convention convention(int conv) {
+  return Convention((conv & EULER_EXTRINSIC) ? Order::EXTRINSIC : Order::INTRINSIC,
+                    (conv & EULER_PASSIVE) ? Direction::PASSIVE : Direction::ACTIVE);
+}
+
+}  // namespace
+
+int euler_api_version(void) { return EULER_C_API_VERSION; }
+
+int euler_parse_sequence(const char* name) {
+  const Sequence sequence(name);
+  return sequence.valid() ? static_cast<int>(sequence.id()) : EULER_INVALID_SEQUENCE;
+}
+
+int euler_to_matrix_batch(const double* angles, size_t n, int seq, int conv, double* out) {
+  const int status = check(angles, n, seq, conv, out);
+  if (status == EULER_OK) {
+    toRotationMatrix(toSequence(seq), reinterpret_cast<const Angles*>(angles), n, convention(conv),
+                     reinterpret_cast<RotationMatrix*>(out));
+  }
+  return status;
+}
+
+int euler_to_quaternion_batch(const double* angles, size_t n, int seq, int conv, double* out) {
+  const int status = check(angles, n, seq, conv, out);
+  if (status == EULER_OK) {
+    toQuaternion(toSequence(seq), reinterpret_cast<const Angles*>(angles), n, convention(conv),
+                 reinterpret_cast<Quaternion*>(out));
+  }
+  return status;
+}
+
+int euler_to_matrix_quaternion_batch(const double* angles, size_t n, int seq, int conv,
+                                     double* matrices, double* quaternions) {
+  int status = check(angles, n, seq, conv, matrices);
+  if (status == EULER_OK && n != 0 && quaternions == nullptr) {
+    status = EULER_INVALID_POINTER;
+  }
+  if (status != EULER_OK) {
+    return status;
+  }
+
+  const Sequence sequence = toSequence(seq);
+  const auto a = reinterpret_cast<const Angles*>(angles);
+  toRotationMatrix(sequence, a, n, convention(conv), reinterpret_cast<RotationMatrix*>(matrices));
+  toQuaternion(sequence, a, n, convention(conv), reinterpret_cast<Quaternion*>(quaternions));
+  return EULER_OK;
+}
+
+int euler_matrix_to_angles_batch(const double* matrices, size_t n, int seq, int conv,
+                                 double* out) {
+  const int status = check(matrices, n, seq, conv, out);
+  if (status == EULER_OK) {
+    toEulerAngles(reinterpret_cast<const RotationMatrix*>(matrices), n, toSequence(seq),
+                  convention(conv), reinterpret_cast<Angles*>(out));
+  }
+  return status;
+}
+
+int euler_quaternion_to_angles_batch(const double* quaternions, size_t n, int seq, int conv,
+                                     double* out) {
+  const int status = check(quaternions, n, seq, conv, out);
+  if (status == EULER_OK) {
+    toEulerAngles(reinterpret_cast<const Quaternion*>(quaternions), n, toSequence(seq),
+                  convention(conv), reinterpret_cast<Angles*>(out));
+  }
+  return status;
+}
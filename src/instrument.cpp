@@ -0,0 +1,69 @@
+#include <euler/instrument.h>
+#include <euler/trace.h>
+
+#include <atomic>
+
+namespace euler {
+namespace {  // anonymous
+
+/**
+ * @brief Totals of one probe, on its own cache line since threads update probes concurrently
+ */
+struct alignas(64) Counters {
+  std::atomic<std::uint64_t> calls;
+  std::atomic<std::uint64_t> records;
+  std::atomic<std::uint64_t> nanoseconds;
+};
+
+Counters probes[PROBE_COUNT];
+
+}  // namespace
+
+const char* probeName(Probe probe) {
+  switch (probe) {
+    case Probe::PARSE:
+      return "parse";
+    case Probe::ROTATION_MATRIX:
+      return "toRotationMatrix";
+    case Probe::QUATERNION:
+      return "toQuaternion";
+    case Probe::FORMAT:
+      return "format";
+  }
+  return "";
+}
+
+#if EULER_INSTRUMENTATION
+void addProbe(Probe probe, std::size_t records, std::uint64_t nanoseconds) {
+  Counters& counters = probes[static_cast<std::size_t>(probe)];
+  counters.calls.fetch_add(1, std::memory_order_relaxed);
+  counters.records.fetch_add(records, std::memory_order_relaxed);
+  counters.nanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+}
+#else
+void addProbe(Probe, std::size_t, std::uint64_t) {}
+#endif
+
+void finishProbe(Probe probe, std::size_t records, std::chrono::steady_clock::time_point start) {
+  const auto end = std::chrono::steady_clock::now();
+  const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+  addProbe(probe, records, elapsed.count());
+  traceEvent(probeName(probe), "probe", start, end, records);
+}
+
+ProbeTotals probeTotals(Probe probe) {
+  const Counters& counters = probes[static_cast<std::size_t>(probe)];
+  return {counters.calls.load(std::memory_order_relaxed),
+          counters.records.load(std::memory_order_relaxed),
+          counters.nanoseconds.load(std::memory_order_relaxed)};
+}
+
+void resetProbes() {
+  for (auto& counters : probes) {
+    counters.calls.store(0, std::memory_order_relaxed);
+    counters.records.store(0, std::memory_order_relaxed);
+    counters.nanoseconds.store(0, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace euler
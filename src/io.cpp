@@ -1,46 +1,314 @@
 #include <euler/io.h>
 
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iomanip>
 #include "euler/rotations.h"
 
 namespace euler {
+namespace {  // anonymous
 
-bool isSequenceValid(const Sequence& seq) {
-  if (seq.length() != 3) {
-    return false;
+/// Significant digits handed to std::strtod when the fast path of parseDouble does not apply. The
+/// halfway points between adjacent doubles have at most 767 significant digits, so truncating to
+/// more digits and appending a sticky digit never moves a number across one
+const int MAX_DIGITS = 800;
+
+/// Mantissas up to 2^53 are exactly representable as doubles
+const std::uint64_t MAX_EXACT_MANTISSA = std::uint64_t(1) << 53;
+
+/// Powers of ten that are exactly representable as doubles
+const double EXACT_POWERS_OF_TEN[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                      1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                      1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+bool isSeparator(char c) { return c == ' ' || c == '\t' || c == ',' || c == '\r'; }
+
+const char* skipSeparators(const char* first, const char* last) {
+  while (first != last && isSeparator(*first)) {
+    ++first;
+  }
+  return first;
+}
+
+/**
+ * @brief Converts significant digits and a decimal exponent to the nearest double
+ *
+ * @details Only used when the digits or exponent are too large for an exact computation. The digits
+ * are rewritten as an integer with an exponent, so that the locale's decimal point never matters.
+ * Digits beyond MAX_DIGITS are replaced by a single sticky digit, which preserves the rounding
+ * (see MAX_DIGITS).
+ */
+double slowConvert(const char* int_first, const char* int_last, const char* frac_first,
+                   const char* frac_last, long long exponent) {
+  char buffer[MAX_DIGITS + 32];
+  int length = 0;
+  bool leading = true;
+  bool sticky = false;
+  const auto append = [&](const char* first, const char* last, bool fraction) {
+    for (; first != last; ++first) {
+      leading = leading && *first == '0';
+      if (leading) {
+        exponent -= fraction ? 1 : 0;
+      } else if (length < MAX_DIGITS) {
+        buffer[length++] = *first;
+        exponent -= fraction ? 1 : 0;
+      } else {
+        sticky = sticky || *first != '0';
+        exponent += fraction ? 0 : 1;
+      }
+    }
+  };
+  append(int_first, int_last, false);
+  append(frac_first, frac_last, true);
+  if (sticky) {
+    buffer[length++] = '1';
+    --exponent;
+  }
+
+  // Beyond these exponents the result is zero or infinite regardless of the digits
+  exponent = std::max(-2000LL, std::min(2000LL, exponent));
+  std::snprintf(buffer + length, sizeof(buffer) - length, "e%lld", exponent);
+  return std::strtod(buffer, nullptr);
+}
+
+/// Values below this magnitude are formatted without snprintf
+const double MAX_FAST_FORMAT = 1e6;
+
+/**
+ * @brief Writes a number with four decimal places, right-aligned in a field of width characters,
+ * to a buffer that ends at last
+ *
+ * @details Produces exactly what printf("%*.4f") does. The fast path scales by 10^4 and rounds to
+ * an integer, and defers to snprintf for large and non-finite values, and whenever the scaled value
+ * is too close to a tie for the rounding direction to be certain. MAX_FORMAT_LENGTH leaves room for
+ * the longest numbers, so the output is never truncated in practice.
+ */
+char* formatFixed(char* out, const char* last, double value, int width) {
+  const double magnitude = std::abs(value);
+  if (magnitude < MAX_FAST_FORMAT) {
+    const double scaled = magnitude * 10000.0;
+    std::uint64_t n = static_cast<std::uint64_t>(scaled);
+    const double fraction = scaled - static_cast<double>(n);
+    if (std::abs(fraction - 0.5) > 1e-5) {
+      n += fraction > 0.5 ? 1 : 0;
+
+      // Digits are written backwards from the end of a scratch buffer
+      char digits[32];
+      char* p = digits + sizeof(digits);
+      for (int i = 0; i < 4; ++i, n /= 10) {
+        *--p = static_cast<char>('0' + n % 10);
+      }
+      *--p = '.';
+      do {
+        *--p = static_cast<char>('0' + n % 10);
+        n /= 10;
+      } while (n > 0);
+      if (std::signbit(value)) {
+        *--p = '-';
+      }
+
+      const int length = static_cast<int>(digits + sizeof(digits) - p);
+      for (int i = length; i < width; ++i) {
+        *out++ = ' ';
+      }
+      std::memcpy(out, p, length);
+      return out + length;
+    }
+  }
+  const int space = static_cast<int>(last - out);
+  return out + std::min(std::snprintf(out, space, "%*.4f", width, value), space - 1);
+}
+
+char* write(char* out, const char* text) {
+  const std::size_t length = std::strlen(text);
+  std::memcpy(out, text, length);
+  return out + length;
+}
+
+}  // namespace
+
+bool isSequenceValid(Sequence sequence) { return sequence.valid(); }
+
+ParseResult parseDouble(const char* first, const char* last, double& value) {
+  const char* p = first;
+  const bool negative = p != last && *p == '-';
+  if (negative) {
+    ++p;
+  }
+
+  // Integer and fraction digits
+  const char* int_first = p;
+  while (p != last && isDigit(*p)) {
+    ++p;
+  }
+  const char* int_last = p;
+  const char* frac_first = p;
+  const char* frac_last = p;
+  if (p != last && *p == '.') {
+    frac_first = ++p;
+    while (p != last && isDigit(*p)) {
+      ++p;
+    }
+    frac_last = p;
+  }
+  if (int_first == int_last && frac_first == frac_last) {
+    return {first, ParseError::INVALID_NUMBER};
   }
 
-  std::array<std::string, 12> sequences = {"xyz", "xzy", "yxz", "yzx", "zxy", "zyx",
-                                           "xyx", "xzx", "yxy", "yzy", "zxz", "zyz"};
-  return std::find(std::begin(sequences), std::end(sequences), seq) != std::end(sequences);
+  // Exponent, only consumed if at least one digit follows the e
+  long long exponent = 0;
+  if (p != last && (*p == 'e' || *p == 'E')) {
+    const char* e = p + 1;
+    const bool negative_exponent = e != last && *e == '-';
+    if (e != last && (*e == '-' || *e == '+')) {
+      ++e;
+    }
+    if (e != last && isDigit(*e)) {
+      for (; e != last && isDigit(*e); ++e) {
+        exponent = std::min(exponent * 10 + (*e - '0'), 100000LL);
+      }
+      exponent = negative_exponent ? -exponent : exponent;
+      p = e;
+    }
+  }
+
+  // Accumulate the significant digits, dropping leading and trailing zeros
+  std::uint64_t mantissa = 0;
+  int significant = 0;
+  long long pending_zeros = 0;
+  long long decimal_exponent = exponent - (frac_last - frac_first);
+  const auto accumulate = [&](const char* digit, const char* end) {
+    for (; digit != end; ++digit) {
+      if (*digit == '0') {
+        pending_zeros += significant > 0 ? 1 : 0;
+        continue;
+      }
+      for (; pending_zeros > 0 && significant <= 19; --pending_zeros, ++significant) {
+        mantissa *= 10;
+      }
+      if (++significant <= 19) {
+        mantissa = mantissa * 10 + (*digit - '0');
+      }
+    }
+  };
+  accumulate(int_first, int_last);
+  accumulate(frac_first, frac_last);
+  decimal_exponent += pending_zeros;
+
+  double result;
+  if (significant == 0) {
+    result = 0.0;
+  } else if (significant <= 19 && mantissa <= MAX_EXACT_MANTISSA && decimal_exponent >= -22 &&
+             decimal_exponent <= 22) {
+    // Both operands are exact, so the single rounding of the product or quotient is correct
+    result = static_cast<double>(mantissa);
+    result = decimal_exponent < 0 ? result / EXACT_POWERS_OF_TEN[-decimal_exponent]
+                                  : result * EXACT_POWERS_OF_TEN[decimal_exponent];
+  } else {
+    result = slowConvert(int_first, int_last, frac_first, frac_last, exponent);
+  }
+
+  if (std::isinf(result)) {
+    return {first, ParseError::OUT_OF_RANGE};
+  }
+  value = negative ? -result : result;
+  return {p, ParseError::NONE};
+}
+
+ParseResult parseAngles(const char* first, const char* last, Angles& angles) {
+  const char* line_last = static_cast<const char*>(std::memchr(first, '\n', last - first));
+  line_last = line_last == nullptr ? last : line_last;
+  const char* next = line_last == last ? last : line_last + 1;
+
+  std::size_t count = 0;
+  for (const char* p = skipSeparators(first, line_last); p != line_last;
+       p = skipSeparators(p, line_last)) {
+    if (count == angles.size()) {
+      return {next, ParseError::TOO_MANY_ANGLES};
+    }
+
+    // Unlike parseDouble, a leading plus sign is accepted
+    if (*p == '+' && p + 1 != line_last && (isDigit(p[1]) || p[1] == '.')) {
+      ++p;
+    }
+    const ParseResult result = parseDouble(p, line_last, angles[count]);
+    if (result.error != ParseError::NONE) {
+      return {next, result.error};
+    }
+    if (result.ptr != line_last && !isSeparator(*result.ptr)) {
+      return {next, ParseError::INVALID_NUMBER};
+    }
+    p = result.ptr;
+    ++count;
+  }
+
+  if (count == 0) {
+    return {next, ParseError::EMPTY_LINE};
+  } else if (count < angles.size()) {
+    return {next, ParseError::TOO_FEW_ANGLES};
+  }
+  return {next, ParseError::NONE};
+}
+
+char* format(char* out, const Quaternion& q) {
+  const char* last = out + MAX_FORMAT_LENGTH;
+  const char* labels[] = {"  w: ", "\n  x: ", "\n  y: ", "\n  z: "};
+  for (int i = 0; i < 4; ++i) {
+    out = formatFixed(write(out, labels[i]), last, q[i], 7);
+  }
+  return out;
+}
+
+char* format(char* out, const RotationMatrix& R) {
+  const char* last = out + MAX_FORMAT_LENGTH;
+  for (int i = 0; i < 9; ++i) {
+    if (i == 3 || i == 6) {
+      *out++ = '\n';
+    }
+    out = formatFixed(out, last, R[i], 8);
+  }
+  return out;
+}
+
+char* formatCompact(char* out, const Quaternion& q) {
+  const char* last = out + MAX_FORMAT_LENGTH;
+  for (int i = 0; i < 4; ++i) {
+    if (i > 0) {
+      *out++ = ' ';
+    }
+    out = formatFixed(out, last, q[i], 0);
+  }
+  return out;
+}
+
+char* formatCompact(char* out, const RotationMatrix& R) {
+  const char* last = out + MAX_FORMAT_LENGTH;
+  for (int i = 0; i < 9; ++i) {
+    if (i > 0) {
+      *out++ = ' ';
+    }
+    out = formatFixed(out, last, R[i], 0);
+  }
+  return out;
 }
 
 std::ostream& operator<<(std::ostream& os, const euler::Quaternion& q) {
-  // clang-format off
-    os << std::fixed << std::setprecision(4) 
-       << "  w: " << std::setw(7) << q[0] << "\n"
-       << "  x: " << std::setw(7) << q[1] << "\n"
-       << "  y: " << std::setw(7) << q[2] << "\n"
-       << "  z: " << std::setw(7) << q[3];
-  // clang-format on
-  return os;
+  // Leaves the stream formatting doubles as it has always done
+  char buffer[MAX_FORMAT_LENGTH];
+  os << std::fixed << std::setprecision(4);
+  return os.write(buffer, format(buffer, q) - buffer);
 }
 
 std::ostream& operator<<(std::ostream& os, const euler::RotationMatrix& R) {
-  // clang-format off
-    os << std::fixed << std::setprecision(4)
-       << std::setw(8) << R[0]
-       << std::setw(8) << R[1]
-       << std::setw(8) << R[2] << "\n"
-       << std::setw(8) << R[3]
-       << std::setw(8) << R[4]
-       << std::setw(8) << R[5] << "\n"
-       << std::setw(8) << R[6]
-       << std::setw(8) << R[7]
-       << std::setw(8) << R[8];
-  // clang-format on
-  return os;
+  char buffer[MAX_FORMAT_LENGTH];
+  os << std::fixed << std::setprecision(4);
+  return os.write(buffer, format(buffer, R) - buffer);
 }
 
 }  // namespace euler
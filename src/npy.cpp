@@ -0,0 +1,284 @@
+#include <euler/npy.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace euler {
+namespace {  // anonymous
+
+/// Every .npy file starts with these six bytes, followed by the major and minor version
+const char MAGIC[] = "\x93NUMPY";
+const std::size_t MAGIC_SIZE = 6;
+
+/// Headers written by NpyArray::create are padded so that the data is aligned to this many bytes
+const std::size_t HEADER_ALIGNMENT = 64;
+
+/**
+ * @brief Finds the value of a key in the dictionary of a .npy header
+ *
+ * @return Pointer to the first character of the value, or null if the key is absent
+ */
+const char* findValue(const std::string& header, const char* key) {
+  const std::string quoted = std::string("'") + key + "'";
+  std::size_t position = header.find(quoted);
+  if (position == std::string::npos) {
+    return nullptr;
+  }
+  position = header.find(':', position + quoted.size());
+  if (position == std::string::npos) {
+    return nullptr;
+  }
+  position = header.find_first_not_of(' ', position + 1);
+  return position == std::string::npos ? nullptr : header.c_str() + position;
+}
+
+/**
+ * @brief Parses the dictionary of a .npy header, e.g. "{'descr': '<f8', 'fortran_order': False,
+ * 'shape': (10, 3), }"
+ */
+NpyError parseHeader(const std::string& header, NpyType& type, bool& fortran_order,
+                     std::vector<std::size_t>& shape) {
+  const char* descr = findValue(header, "descr");
+  const char* order = findValue(header, "fortran_order");
+  const char* p = findValue(header, "shape");
+  if (descr == nullptr || order == nullptr || p == nullptr) {
+    return NpyError::INVALID_HEADER;
+  }
+
+  if (std::strncmp(descr, "'<f8'", 5) == 0) {
+    type = NpyType::FLOAT64;
+  } else if (std::strncmp(descr, "'<f4'", 5) == 0) {
+    type = NpyType::FLOAT32;
+  } else {
+    return NpyError::UNSUPPORTED_TYPE;
+  }
+
+  if (std::strncmp(order, "True", 4) == 0) {
+    fortran_order = true;
+  } else if (std::strncmp(order, "False", 5) == 0) {
+    fortran_order = false;
+  } else {
+    return NpyError::INVALID_HEADER;
+  }
+
+  // The shape is a tuple of integers such as (), (10,) or (10, 3)
+  if (*p++ != '(') {
+    return NpyError::INVALID_HEADER;
+  }
+  shape.clear();
+  while (true) {
+    while (*p == ' ' || *p == ',') {
+      ++p;
+    }
+    if (*p == ')') {
+      return NpyError::NONE;
+    }
+    if (*p < '0' || *p > '9') {
+      return NpyError::INVALID_HEADER;
+    }
+    std::size_t extent = 0;
+    while (*p >= '0' && *p <= '9') {
+      const std::size_t digit = static_cast<std::size_t>(*p++ - '0');
+      if (extent > (SIZE_MAX - digit) / 10) {
+        return NpyError::INVALID_HEADER;
+      }
+      extent = 10 * extent + digit;
+    }
+    shape.push_back(extent);
+  }
+}
+
+std::size_t elementSize(NpyType type) { return type == NpyType::FLOAT64 ? 8 : 4; }
+
+/**
+ * @brief Multiplies the extents of a shape
+ *
+ * @return False if the product does not fit in a std::size_t
+ */
+bool elementCount(const std::vector<std::size_t>& shape, std::size_t& count) {
+  count = 1;
+  for (const auto extent : shape) {
+    if (extent != 0 && count > SIZE_MAX / extent) {
+      return false;
+    }
+    count *= extent;
+  }
+  return true;
+}
+
+/**
+ * @brief Reads one element of an array as a double
+ */
+double element(const NpyArray& array, std::size_t index) {
+  if (array.type() == NpyType::FLOAT64) {
+    double value;
+    std::memcpy(&value, array.data() + 8 * index, sizeof(value));
+    return value;
+  }
+  float value;
+  std::memcpy(&value, array.data() + 4 * index, sizeof(value));
+  return value;
+}
+
+template <typename T>
+NpyError write(const std::string& path, const T* values, std::size_t count,
+               const std::vector<std::size_t>& shape) {
+  NpyArray array;
+  const NpyError error = array.create(path, shape);
+  if (error != NpyError::NONE) {
+    return error;
+  }
+  if (count > 0) {
+    std::memcpy(array.data(), values, count * sizeof(T));
+  }
+  return array.sync() ? NpyError::NONE : NpyError::CANNOT_WRITE;
+}
+
+}  // namespace
+
+NpyError NpyArray::openRead(const std::string& path) {
+  data_ = nullptr;
+  shape_.clear();
+  if (!file_.openRead(path)) {
+    return NpyError::CANNOT_OPEN;
+  }
+
+  // The magic string, the version and the length of the header
+  const char* p = file_.data();
+  const std::size_t size = file_.size();
+  if (size < MAGIC_SIZE + 4 || std::memcmp(p, MAGIC, MAGIC_SIZE) != 0) {
+    return NpyError::INVALID_HEADER;
+  }
+  const int major = static_cast<unsigned char>(p[MAGIC_SIZE]);
+  std::size_t header_size;
+  std::size_t offset;
+  if (major == 1) {
+    header_size = static_cast<unsigned char>(p[8]) | static_cast<unsigned char>(p[9]) << 8;
+    offset = 10;
+  } else if ((major == 2 || major == 3) && size >= 12) {
+    header_size = 0;
+    for (int i = 3; i >= 0; --i) {
+      header_size = header_size << 8 | static_cast<unsigned char>(p[8 + i]);
+    }
+    offset = 12;
+  } else {
+    return NpyError::INVALID_HEADER;
+  }
+  if (size < offset + header_size) {
+    return NpyError::INVALID_HEADER;
+  }
+
+  const std::string header(p + offset, header_size);
+  const NpyError error = parseHeader(header, type_, fortran_order_, shape_);
+  if (error != NpyError::NONE) {
+    shape_.clear();
+    return error;
+  }
+  std::size_t count;
+  if (!elementCount(shape_, count)) {
+    shape_.clear();
+    return NpyError::INVALID_HEADER;
+  }
+  offset += header_size;
+  if (count > (size - offset) / elementSize(type_)) {
+    shape_.clear();
+    return NpyError::TRUNCATED;
+  }
+  data_ = file_.data() + offset;
+  return NpyError::NONE;
+}
+
+NpyError NpyArray::create(const std::string& path, const std::vector<std::size_t>& shape) {
+  data_ = nullptr;
+  type_ = NpyType::FLOAT64;
+  fortran_order_ = false;
+  shape_ = shape;
+
+  // Tuples of one element need a trailing comma, as in (10,)
+  std::string tuple;
+  for (std::size_t i = 0; i < shape.size(); ++i) {
+    tuple += std::to_string(shape[i]) + (i + 1 < shape.size() ? ", " : "");
+  }
+  if (shape.size() == 1) {
+    tuple += ",";
+  }
+  std::string header = "{'descr': '<f8', 'fortran_order': False, 'shape': (" + tuple + "), }";
+
+  // Pad with spaces and end with a newline so that the data is aligned
+  const std::size_t prefix_size = MAGIC_SIZE + 4;
+  const std::size_t unpadded_size = prefix_size + header.size() + 1;
+  const std::size_t padded_size =
+      (unpadded_size + HEADER_ALIGNMENT - 1) / HEADER_ALIGNMENT * HEADER_ALIGNMENT;
+  header.resize(padded_size - prefix_size - 1, ' ');
+  header += '\n';
+
+  std::size_t count;
+  if (!elementCount(shape, count) || count > (SIZE_MAX - padded_size) / 8 ||
+      !file_.create(path, padded_size + 8 * count)) {
+    shape_.clear();
+    return NpyError::CANNOT_OPEN;
+  }
+  char* p = file_.data();
+  std::memcpy(p, MAGIC, MAGIC_SIZE);
+  p[6] = 1;
+  p[7] = 0;
+  p[8] = static_cast<char>(header.size() & 0xff);
+  p[9] = static_cast<char>(header.size() >> 8);
+  std::memcpy(p + prefix_size, header.data(), header.size());
+  data_ = p + padded_size;
+  return NpyError::NONE;
+}
+
+NpyError checkAngles(const NpyArray& array) {
+  const auto& shape = array.shape();
+  return shape.size() == 2 && shape[1] == 3 ? NpyError::NONE : NpyError::INVALID_SHAPE;
+}
+
+const Angles* anglesData(const NpyArray& array) {
+  const bool aligned = reinterpret_cast<std::uintptr_t>(array.data()) % alignof(Angles) == 0;
+  if (array.type() != NpyType::FLOAT64 || (array.fortranOrder() && array.shape()[0] > 1) ||
+      !aligned) {
+    return nullptr;
+  }
+  return reinterpret_cast<const Angles*>(array.data());
+}
+
+void readAngles(const NpyArray& array, std::size_t first, std::size_t count, Angles* out) {
+  const Angles* angles = anglesData(array);
+  if (angles != nullptr) {
+    std::copy(angles + first, angles + first + count, out);
+    return;
+  }
+
+  const std::size_t rows = array.shape()[0];
+  for (std::size_t i = 0; i < count; ++i) {
+    for (std::size_t j = 0; j < 3; ++j) {
+      const std::size_t row = first + i;
+      out[i][j] = element(array, array.fortranOrder() ? j * rows + row : 3 * row + j);
+    }
+  }
+}
+
+NpyError readNpy(const std::string& path, std::vector<Angles>& angles) {
+  NpyArray array;
+  NpyError error = array.openRead(path);
+  if (error == NpyError::NONE) {
+    error = checkAngles(array);
+  }
+  if (error == NpyError::NONE) {
+    angles.resize(array.shape()[0]);
+    readAngles(array, 0, angles.size(), angles.data());
+  }
+  return error;
+}
+
+NpyError writeNpy(const std::string& path, const RotationMatrix* R, std::size_t count) {
+  return write(path, R, count, {count, 3, 3});
+}
+
+NpyError writeNpy(const std::string& path, const Quaternion* q, std::size_t count) {
+  return write(path, q, count, {count, 4});
+}
+
+}  // namespace euler
@@ -0,0 +1,226 @@
+#include <euler/parallel.h>
+#include <euler/trace.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace euler {
+namespace {  // anonymous
+
+/**
+ * @brief Chunks [begin, end) of a loop still to be run by one thread
+ */
+struct Share {
+  std::mutex mutex;
+  std::size_t begin = 0;
+  std::size_t end = 0;
+};
+
+}  // namespace
+
+struct ThreadPool::State {
+  std::vector<std::thread> threads;
+  std::unique_ptr<Share[]> shares;
+  std::size_t size = 1;
+
+  // The loop being run, with its range counted in chunks
+  const std::function<void(std::size_t, std::size_t)>* body = nullptr;
+  std::size_t count = 0;
+  std::size_t chunk = 1;
+
+  std::mutex mutex;
+  std::condition_variable start;
+  std::condition_variable done;
+  std::size_t generation = 0;
+  std::size_t running = 0;
+  bool stop = false;
+
+  /**
+   * @brief Takes the next chunk from the front of the share of thread index
+   */
+  bool take(std::size_t index, std::size_t& c) {
+    Share& share = shares[index];
+    std::lock_guard<std::mutex> lock(share.mutex);
+    if (share.begin == share.end) {
+      return false;
+    }
+    c = share.begin++;
+    return true;
+  }
+
+  /**
+   * @brief Moves the back half of the share of the first other thread with chunks left into the
+   * share of thread index
+   */
+  bool steal(std::size_t index) {
+    for (std::size_t k = 1; k < size; ++k) {
+      Share& victim = shares[(index + k) % size];
+      std::size_t begin, end;
+      {
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.begin == victim.end) {
+          continue;
+        }
+        end = victim.end;
+        begin = victim.end - (victim.end - victim.begin + 1) / 2;
+        victim.end = begin;
+      }
+      Share& own = shares[index];
+      std::lock_guard<std::mutex> lock(own.mutex);
+      own.begin = begin;
+      own.end = end;
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * @brief Runs chunks on thread index until no thread has any left
+   */
+  void work(std::size_t index) {
+    std::size_t c;
+    do {
+      while (take(index, c)) {
+        const std::size_t begin = c * chunk;
+        const std::size_t end = std::min(begin + chunk, count);
+        const TraceScope scope("chunk", "parallel", end - begin);
+        (*body)(begin, end);
+      }
+    } while (steal(index));
+  }
+
+  /**
+   * @brief Main loop of the threads started by the pool
+   */
+  void run(std::size_t index) {
+    setTraceThreadName("pool " + std::to_string(index));
+    std::size_t seen = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        start.wait(lock, [&] { return stop || generation != seen; });
+        if (stop) {
+          return;
+        }
+        seen = generation;
+      }
+      work(index);
+      std::lock_guard<std::mutex> lock(mutex);
+      if (--running == 0) {
+        done.notify_one();
+      }
+    }
+  }
+};
+
+ThreadPool::ThreadPool(std::size_t threads) : state_(new State) {
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  state_->size = threads;
+  state_->shares.reset(new Share[threads]);
+  for (std::size_t i = 1; i < threads; ++i) {
+    state_->threads.emplace_back(&State::run, state_.get(), i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->stop = true;
+  }
+  state_->start.notify_all();
+  for (auto& thread : state_->threads) {
+    thread.join();
+  }
+}
+
+std::size_t ThreadPool::size() const { return state_->size; }
+
+void ThreadPool::parallelFor(std::size_t count, std::size_t chunk,
+                             const std::function<void(std::size_t, std::size_t)>& body) {
+  State& state = *state_;
+  const std::size_t chunks = (count + chunk - 1) / chunk;
+  if (state.size == 1 || chunks <= 1) {
+    for (std::size_t begin = 0; begin < count; begin += chunk) {
+      const std::size_t end = std::min(begin + chunk, count);
+      const TraceScope scope("chunk", "parallel", end - begin);
+      body(begin, end);
+    }
+    return;
+  }
+
+  state.body = &body;
+  state.count = count;
+  state.chunk = chunk;
+  for (std::size_t i = 0; i < state.size; ++i) {
+    std::lock_guard<std::mutex> lock(state.shares[i].mutex);
+    state.shares[i].begin = chunks * i / state.size;
+    state.shares[i].end = chunks * (i + 1) / state.size;
+  }
+  {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.running = state.size - 1;
+    ++state.generation;
+  }
+  state.start.notify_all();
+
+  state.work(0);
+  std::unique_lock<std::mutex> lock(state.mutex);
+  state.done.wait(lock, [&] { return state.running == 0; });
+}
+
+void toRotationMatrix(Sequence sequence, const Angles* angles, std::size_t count,
+                      Convention convention, RotationMatrix* out, ThreadPool& pool) {
+  pool.parallelFor(count, PARALLEL_CHUNK_SIZE, [&](std::size_t begin, std::size_t end) {
+    toRotationMatrix(sequence, angles + begin, end - begin, convention, out + begin);
+  });
+}
+
+void toQuaternion(Sequence sequence, const Angles* angles, std::size_t count,
+                  Convention convention, Quaternion* out, ThreadPool& pool) {
+  pool.parallelFor(count, PARALLEL_CHUNK_SIZE, [&](std::size_t begin, std::size_t end) {
+    toQuaternion(sequence, angles + begin, end - begin, convention, out + begin);
+  });
+}
+
+void toRotationMatrix(const ConventionCode* codes, const Angles* angles, std::size_t count,
+                      RotationMatrix* out, ThreadPool& pool) {
+  pool.parallelFor(count, PARALLEL_CHUNK_SIZE, [&](std::size_t begin, std::size_t end) {
+    toRotationMatrix(codes + begin, angles + begin, end - begin, out + begin);
+  });
+}
+
+void toQuaternion(const ConventionCode* codes, const Angles* angles, std::size_t count,
+                  Quaternion* out, ThreadPool& pool) {
+  pool.parallelFor(count, PARALLEL_CHUNK_SIZE, [&](std::size_t begin, std::size_t end) {
+    toQuaternion(codes + begin, angles + begin, end - begin, out + begin);
+  });
+}
+
+void toEulerAngles(const RotationMatrix* R, std::size_t count, Sequence sequence,
+                   Convention convention, Angles* out, ThreadPool& pool) {
+  pool.parallelFor(count, PARALLEL_CHUNK_SIZE, [&](std::size_t begin, std::size_t end) {
+    toEulerAngles(R + begin, end - begin, sequence, convention, out + begin);
+  });
+}
+
+void toEulerAngles(const Quaternion* q, std::size_t count, Sequence sequence,
+                   Convention convention, Angles* out, ThreadPool& pool) {
+  pool.parallelFor(count, PARALLEL_CHUNK_SIZE, [&](std::size_t begin, std::size_t end) {
+    toEulerAngles(q + begin, end - begin, sequence, convention, out + begin);
+  });
+}
+
+void toBinaryRecords(Sequence sequence, const Angles* angles, std::size_t count,
+                     Convention convention, BinaryRecord* out, ThreadPool& pool) {
+  pool.parallelFor(count, PARALLEL_CHUNK_SIZE, [&](std::size_t begin, std::size_t end) {
+    toBinaryRecords(sequence, angles + begin, end - begin, convention, out + begin);
+  });
+}
+
+}  // namespace euler
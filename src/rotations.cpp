@@ -1,114 +1,304 @@
 #include <euler/rotations.h>
+#include <euler/kernels.h>
+#include <euler/rotations_impl.h>
 
+#include <euler/instrument.h>
+#include <euler/sincos.h>
+
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 
 namespace euler {
 namespace {  // anonymous
 
-RotationMatrix R_active_x(double angle) {
-  const auto c = std::cos(angle);
-  const auto s = std::sin(angle);
-  // clang-format off
-  RotationMatrix ret = {1.0,  0.0,  0.0,
-                        0.0,    c,   -s,
-                        0.0,    s,    c};
-  // clang-format on
-  return ret;
+using kernels::arrange;
+using kernels::Dispatch;
+using kernels::evaluate;
+using kernels::evaluateQuaternion;
+using kernels::resolve;
+
+static_assert(sizeof(Angles) == 3 * sizeof(double), "Batches of angles must be contiguous");
+
+/// Number of sets of angles whose sines and cosines are computed together in batch conversions
+const std::size_t BLOCK_SIZE = 128;
+
+/// Dispatches of every valid ConventionCode, indexed by value and resolved once
+const std::array<Dispatch, CONVENTION_CODE_COUNT>& dispatches() {
+  static const std::array<Dispatch, CONVENTION_CODE_COUNT> table = [] {
+    std::array<Dispatch, CONVENTION_CODE_COUNT> t;
+    for (std::size_t i = 0; i < t.size(); ++i) {
+      const auto code = ConventionCode::fromValue(static_cast<std::uint8_t>(i));
+      t[i] = resolve(code.sequence(), code.convention());
+    }
+    return t;
+  }();
+  return table;
 }
 
-RotationMatrix R_active_y(double angle) {
-  const auto c = std::cos(angle);
-  const auto s = std::sin(angle);
-  // clang-format off
-  RotationMatrix ret = {  c,  0.0,    s,
-                        0.0,  1.0,  0.0,
-                         -s,  0.0,    c};
-  // clang-format on
-  return ret;
+const Dispatch& dispatch(ConventionCode code) {
+  assert(code.valid() && "invalid convention code");
+  return dispatches()[code.value()];
 }
 
-RotationMatrix R_active_z(double angle) {
-  const auto c = std::cos(angle);
-  const auto s = std::sin(angle);
-  // clang-format off
-  RotationMatrix ret = {  c,   -s,  0.0,
-                          s,    c,  0.0,
-                        0.0,  0.0,  1.0};
-  // clang-format on
-  return ret;
-}
-
-RotationMatrix R_active(char axis, double angle) {
-  assert(axis == 'x' || axis == 'y' || axis == 'z');
-
-  RotationMatrix R;
-  switch (axis) {
-    case 'x':
-      R = R_active_x(angle);
-      break;
-    case 'y':
-      R = R_active_y(angle);
-      break;
-    case 'z':
-      R = R_active_z(angle);
-      break;
+/**
+ * @brief A sequence and convention resolved for conversion back to euler angles
+ *
+ * @details Passive rotations are inverted first, and extrinsic sequences are solved as the
+ * reversed intrinsic sequence with the angles reversed afterwards (see Dispatch). What remains is
+ * an active, intrinsic rotation R_i(x1) * R_j(x2) * R_k(x3), or R_i(x1) * R_j(x2) * R_i(x3) for a
+ * proper Euler sequence, in which case k is the axis not in the sequence.
+ */
+struct InverseDispatch {
+  int i, j, k;    ///< Axes (x = 0, y = 1, z = 2)
+  bool proper;    ///< The sequence repeats its first axis
+  double parity;  ///< +1 if (i, j, k) is a cyclic permutation of (x, y, z), -1 otherwise
+  bool reverse;   ///< Solve the reversed sequence, reverse the angles and zero x1 at gimbal lock
+  bool invert;    ///< Invert the rotation before solving
+};
+
+InverseDispatch resolveInverse(Sequence sequence, Convention convention) {
+  assert(sequence.valid() && "invalid rotation sequence");
+
+  InverseDispatch d;
+  d.reverse = convention.order == Order::EXTRINSIC;
+  d.invert = convention.direction == Direction::PASSIVE;
+  d.i = static_cast<int>(sequence.axis(d.reverse ? 2 : 0));
+  d.j = static_cast<int>(sequence.axis(1));
+  d.k = static_cast<int>(sequence.axis(d.reverse ? 0 : 2));
+  d.proper = d.i == d.k;
+  if (d.proper) {
+    d.k = 3 - d.i - d.j;
+  }
+  d.parity = (d.j == (d.i + 1) % 3) ? 1.0 : -1.0;
+  return d;
+}
+
+RotationMatrix inverse(const RotationMatrix& R) { return transpose(R); }
+
+Quaternion inverse(const Quaternion& q) { return {q[0], -q[1], -q[2], -q[3]}; }
+
+/// Wraps an angle in [-2 pi, 2 pi] to [-pi, pi]
+double wrap(double angle) {
+  if (angle > M_PI) {
+    return angle - 2.0 * M_PI;
+  } else if (angle < -M_PI) {
+    return angle + 2.0 * M_PI;
   }
+  return angle;
+}
+
+/// Active rotation about axis (x = 0, y = 1, z = 2)
+RotationMatrix R_active(int axis, double angle) {
+  const int a1 = (axis + 1) % 3;
+  const int a2 = (axis + 2) % 3;
+  RotationMatrix R = {};
+  R[4 * axis] = 1.0;
+  R[4 * a1] = std::cos(angle);
+  R[4 * a2] = R[4 * a1];
+  R[3 * a2 + a1] = std::sin(angle);
+  R[3 * a1 + a2] = -R[3 * a2 + a1];
   return R;
 }
-}  // namespace
 
-RotationMatrix operator*(const RotationMatrix& lhs, const RotationMatrix& rhs) {
-  return {lhs[0] * rhs[0] + lhs[1] * rhs[3] + lhs[2] * rhs[6],
-          lhs[0] * rhs[1] + lhs[1] * rhs[4] + lhs[2] * rhs[7],
-          lhs[0] * rhs[2] + lhs[1] * rhs[5] + lhs[2] * rhs[8],
-          lhs[3] * rhs[0] + lhs[4] * rhs[3] + lhs[5] * rhs[6],
-          lhs[3] * rhs[1] + lhs[4] * rhs[4] + lhs[5] * rhs[7],
-          lhs[3] * rhs[2] + lhs[4] * rhs[5] + lhs[5] * rhs[8],
-          lhs[6] * rhs[0] + lhs[7] * rhs[3] + lhs[8] * rhs[6],
-          lhs[6] * rhs[1] + lhs[7] * rhs[4] + lhs[8] * rhs[7],
-          lhs[6] * rhs[2] + lhs[7] * rhs[5] + lhs[8] * rhs[8]};
+/// Solves R = R_i(x1) * R_j(x2) * R_k(x3) (or R_i(x3) if proper) for x1, x2 and x3
+Angles solve(const InverseDispatch& d, const RotationMatrix& R) {
+  const auto at = [&R](int row, int col) { return R[3 * row + col]; };
+  const int i = d.i;
+  const int j = d.j;
+  const int k = d.k;
+  const double e = d.parity;
+
+  Angles x;
+  double distance;  // |sin| or |cos| of x2, which vanishes at gimbal lock
+  if (d.proper) {
+    distance = std::hypot(at(i, j), at(i, k));
+    x[1] = std::atan2(distance, at(i, i));
+    x[0] = std::atan2(at(j, i), -e * at(k, i));
+    x[2] = std::atan2(at(i, j), e * at(i, k));
+  } else {
+    distance = std::hypot(at(i, i), at(i, j));
+    x[1] = std::atan2(e * at(i, k), distance);
+    x[0] = std::atan2(-e * at(j, k), at(k, k));
+    x[2] = std::atan2(-e * at(i, j), at(i, i));
+  }
+
+  if (distance <= GIMBAL_LOCK_TOLERANCE) {
+    // Only x1 + x3 or x1 - x3 is defined; zero one and solve the remaining elemental rotation
+    const RotationMatrix R_j = R_active(j, x[1]);
+    if (d.reverse) {
+      const int third = d.proper ? i : k;
+      const RotationMatrix N = transpose(R_j) * R;
+      const int a1 = (third + 1) % 3;
+      const int a2 = (third + 2) % 3;
+      x[0] = 0.0;
+      x[2] = std::atan2(N[3 * a2 + a1], N[4 * a1]);
+    } else {
+      const RotationMatrix M = R * transpose(R_j);
+      const int a1 = (i + 1) % 3;
+      const int a2 = (i + 2) % 3;
+      x[0] = std::atan2(M[3 * a2 + a1], M[4 * a1]);
+      x[2] = 0.0;
+    }
+  }
+  return x;
 }
 
-RotationMatrix transpose(const RotationMatrix& R) {
+/**
+ * @brief Solves q = q_i(x1) * q_j(x2) * q_k(x3) (or q_i(x3) if proper) for x1, x2 and x3
+ *
+ * @details The quaternion is rearranged into two pairs, (a, b) = cos(h) * (cos u, sin u) and
+ * (c, f) = sin(h) * (cos v, sin v), where h is half of x2 (offset by pi/4 when not proper), from
+ * which x1 = u + v and x3 = sigma * (u - v).
+ */
+Angles solve(const InverseDispatch& d, const Quaternion& q) {
+  const double w = q[0];
+  const double q_i = q[1 + d.i];
+  const double q_j = q[1 + d.j];
+  const double q_k = d.parity * q[1 + d.k];
+
+  double a, b, c, f, sigma;
+  if (d.proper) {
+    a = w;
+    b = q_i;
+    c = q_j;
+    f = q_k;
+    sigma = 1.0;
+  } else {
+    a = w - q_j;
+    b = q_i - q_k;
+    c = w + q_j;
+    f = q_i + q_k;
+    sigma = -d.parity;
+  }
+
+  const double h = std::atan2(std::hypot(c, f), std::hypot(a, b));
+  const double u = std::atan2(b, a);
+  const double v = std::atan2(f, c);
+
+  Angles x;
+  x[1] = d.proper ? 2.0 * h : 2.0 * h - M_PI_2;
+  if (h <= 0.5 * GIMBAL_LOCK_TOLERANCE) {
+    // v is undefined, only x1 + sigma * x3 = 2 u is known
+    x[0] = d.reverse ? 0.0 : 2.0 * u;
+    x[2] = d.reverse ? sigma * 2.0 * u : 0.0;
+  } else if (h >= M_PI_2 - 0.5 * GIMBAL_LOCK_TOLERANCE) {
+    // u is undefined, only x1 - sigma * x3 = 2 v is known
+    x[0] = d.reverse ? 0.0 : 2.0 * v;
+    x[2] = d.reverse ? -sigma * 2.0 * v : 0.0;
+  } else {
+    x[0] = u + v;
+    x[2] = sigma * (u - v);
+  }
+  x[0] = wrap(x[0]);
+  x[2] = wrap(x[2]);
+  return x;
+}
+
+template <typename Rotation>
+Angles toEulerAngles(const InverseDispatch& d, const Rotation& rotation) {
+  const Angles x = solve(d, d.invert ? inverse(rotation) : rotation);
+  return d.reverse ? Angles{x[2], x[1], x[0]} : x;
+}
+}  // namespace
+
+const char* Sequence::name() const {
   // clang-format off
-  return {R[0], R[3], R[6], 
-          R[1], R[4], R[7], 
-          R[2], R[5], R[8]};
+  static const std::array<const char*, 13> names = {{"xyz", "xzy", "yxz", "yzx", "zxy", "zyx",
+                                                     "xyx", "xzx", "yxy", "yzy", "zxz", "zyz",
+                                                     ""}};
   // clang-format on
+  return names[valid() ? index() : 12];
 }
 
-RotationMatrix toRotationMatrix(const Sequence& sequence, const Angles& angles,
-                                Convention convention) {
-  assert(sequence.size() == 3);
-  assert(angles.size() == 3);
+void toRotationMatrix(Sequence sequence, const Angles* angles, std::size_t count,
+                      Convention convention, RotationMatrix* out) {
+  const ProbeTimer timer(Probe::ROTATION_MATRIX, count);
 
-  RotationMatrix R;
+  // Resolve the kernel once for the whole batch, and compute sines and cosines a block at a time
+  const Dispatch d = resolve(sequence, convention);
+  std::array<double, 3 * BLOCK_SIZE> s, c;
+  for (std::size_t begin = 0; begin < count; begin += BLOCK_SIZE) {
+    const std::size_t n = std::min(BLOCK_SIZE, count - begin);
+    sincos(angles[begin].data(), 3 * n, s.data(), c.data());
+    for (std::size_t i = 0; i < n; ++i) {
+      out[begin + i] = evaluate(d, arrange(d, &s[3 * i], &c[3 * i]));
+    }
+  }
+}
 
-  if (convention.order == Order::INTRINSIC) {
-    R = R_active(sequence[0], angles[0]) * R_active(sequence[1], angles[1]) *
-        R_active(sequence[2], angles[2]);
-  } else {
-    R = R_active(sequence[2], angles[2]) * R_active(sequence[1], angles[1]) *
-        R_active(sequence[0], angles[0]);
+void toRotationMatrix(const ConventionCode* codes, const Angles* angles, std::size_t count,
+                      RotationMatrix* out) {
+  const ProbeTimer timer(Probe::ROTATION_MATRIX, count);
+
+  // The sines and cosines do not depend on the codes, so only the kernel varies per record
+  std::array<double, 3 * BLOCK_SIZE> s, c;
+  for (std::size_t begin = 0; begin < count; begin += BLOCK_SIZE) {
+    const std::size_t n = std::min(BLOCK_SIZE, count - begin);
+    sincos(angles[begin].data(), 3 * n, s.data(), c.data());
+    for (std::size_t i = 0; i < n; ++i) {
+      const Dispatch& d = dispatch(codes[begin + i]);
+      out[begin + i] = evaluate(d, arrange(d, &s[3 * i], &c[3 * i]));
+    }
+  }
+}
+
+void toQuaternion(Sequence sequence, const Angles* angles, std::size_t count,
+                  Convention convention, Quaternion* out) {
+  const ProbeTimer timer(Probe::QUATERNION, count);
+  const Dispatch d = resolve(sequence, convention);
+  std::array<double, 3 * BLOCK_SIZE> half, s, c;
+  for (std::size_t begin = 0; begin < count; begin += BLOCK_SIZE) {
+    const std::size_t n = std::min(BLOCK_SIZE, count - begin);
+    for (std::size_t i = 0; i < 3 * n; ++i) {
+      half[i] = 0.5 * angles[begin].data()[i];
+    }
+    sincos(half.data(), 3 * n, s.data(), c.data());
+    for (std::size_t i = 0; i < n; ++i) {
+      out[begin + i] = evaluateQuaternion(d, arrange(d, &s[3 * i], &c[3 * i]));
+    }
   }
+}
 
-  return (convention.direction == Direction::ACTIVE) ? R : transpose(R);
+void toQuaternion(const ConventionCode* codes, const Angles* angles, std::size_t count,
+                  Quaternion* out) {
+  const ProbeTimer timer(Probe::QUATERNION, count);
+  std::array<double, 3 * BLOCK_SIZE> half, s, c;
+  for (std::size_t begin = 0; begin < count; begin += BLOCK_SIZE) {
+    const std::size_t n = std::min(BLOCK_SIZE, count - begin);
+    for (std::size_t i = 0; i < 3 * n; ++i) {
+      half[i] = 0.5 * angles[begin].data()[i];
+    }
+    sincos(half.data(), 3 * n, s.data(), c.data());
+    for (std::size_t i = 0; i < n; ++i) {
+      const Dispatch& d = dispatch(codes[begin + i]);
+      out[begin + i] = evaluateQuaternion(d, arrange(d, &s[3 * i], &c[3 * i]));
+    }
+  }
 }
 
-Quaternion toQuaternion(const RotationMatrix& R) {
-  Quaternion q;
-  q[0] = std::sqrt(std::max(0.0, 1.0 + R[0] + R[4] + R[8])) / 2.0;
+Angles toEulerAngles(const RotationMatrix& R, Sequence sequence, Convention convention) {
+  return toEulerAngles(resolveInverse(sequence, convention), R);
+}
 
-  q[1] = std::sqrt(std::max(0.0, 1.0 + R[0] - R[4] - R[8])) / 2.0;
-  q[1] = std::copysign(q[1], R[7] - R[5]);
+Angles toEulerAngles(const Quaternion& q, Sequence sequence, Convention convention) {
+  return toEulerAngles(resolveInverse(sequence, convention), q);
+}
 
-  q[2] = std::sqrt(std::max(0.0, 1.0 - R[0] + R[4] - R[8])) / 2.0;
-  q[2] = std::copysign(q[2], R[2] - R[6]);
+void toEulerAngles(const RotationMatrix* R, std::size_t count, Sequence sequence,
+                   Convention convention, Angles* out) {
+  const InverseDispatch d = resolveInverse(sequence, convention);
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = toEulerAngles(d, R[i]);
+  }
+}
 
-  q[3] = std::sqrt(std::max(0.0, 1.0 - R[0] - R[4] + R[8])) / 2.0;
-  q[3] = std::copysign(q[3], R[3] - R[1]);
-  return q;
+void toEulerAngles(const Quaternion* q, std::size_t count, Sequence sequence,
+                   Convention convention, Angles* out) {
+  const InverseDispatch d = resolveInverse(sequence, convention);
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = toEulerAngles(d, q[i]);
+  }
 }
 
 }  // namespace euler
@@ -0,0 +1,418 @@
+#include <euler/server.h>
+
+#include <euler/binary.h>
+#include <euler/io.h>
+
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace euler {
+namespace {  // anonymous
+
+using protocol::RequestHeader;
+using protocol::ResponseHeader;
+using protocol::Status;
+
+/// Bytes read from a connection at a time
+const std::size_t RECEIVE_SIZE = 1 << 16;
+
+/**
+ * @brief Fills in the address of a Unix domain socket
+ *
+ * @return False if the path is too long
+ */
+bool address(const std::string& path, sockaddr_un& addr) {
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path)) {
+    return false;
+  }
+  std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+  return true;
+}
+
+/**
+ * @brief Removes the socket file at path if no server is listening on it any more
+ *
+ * @return True if nothing is left at path, false if it is not a socket or a server is listening
+ */
+bool removeStaleSocket(const std::string& path, const sockaddr_un& addr) {
+  struct stat info;
+  if (::lstat(path.c_str(), &info) != 0) {
+    return errno == ENOENT;
+  }
+  if (!S_ISSOCK(info.st_mode)) {
+    return false;
+  }
+  const int probe = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (probe == -1) {
+    return false;
+  }
+  const bool live =
+      ::connect(probe, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0;
+  ::close(probe);
+  return !live && ::unlink(path.c_str()) == 0;
+}
+
+/**
+ * @brief Appends a response header to a buffer
+ */
+void respond(std::vector<char>& out, Status status, std::uint8_t outputs, std::uint32_t count) {
+  ResponseHeader header;
+  header.status = status;
+  header.outputs = outputs;
+  header.count = count;
+  const char* bytes = reinterpret_cast<const char*>(&header);
+  out.insert(out.end(), bytes, bytes + sizeof(header));
+}
+
+/**
+ * @brief Converts the angles of one valid request and appends the response to a buffer
+ */
+void convert(const RequestHeader& header, const char* body, ThreadPool& pool,
+             std::vector<char>& out) {
+  std::vector<Angles> angles(header.count);
+  std::memcpy(angles.data(), body, header.count * sizeof(Angles));
+  if (header.flags & protocol::FLAG_DEGREES) {
+    for (auto& a : angles) {
+      for (auto& x : a) {
+        x *= M_PI / 180;
+      }
+    }
+  }
+
+  const Sequence sequence(header.sequence, 3);
+  const Convention convention(header.order ? Order::EXTRINSIC : Order::INTRINSIC,
+                              header.direction ? Direction::PASSIVE : Direction::ACTIVE);
+  respond(out, Status::OK, header.outputs, header.count);
+  const std::size_t offset = out.size();
+  out.resize(offset + header.count * protocol::resultSize(header.outputs));
+  char* results = out.data() + offset;
+
+  if (header.outputs == (protocol::OUTPUT_MATRIX | protocol::OUTPUT_QUATERNION)) {
+    std::vector<BinaryRecord> records(header.count);
+    toBinaryRecords(sequence, angles.data(), angles.size(), convention, records.data(), pool);
+    std::memcpy(results, records.data(), records.size() * sizeof(BinaryRecord));
+  } else if (header.outputs == protocol::OUTPUT_MATRIX) {
+    std::vector<RotationMatrix> R(header.count);
+    toRotationMatrix(sequence, angles.data(), angles.size(), convention, R.data(), pool);
+    std::memcpy(results, R.data(), R.size() * sizeof(RotationMatrix));
+  } else {
+    std::vector<Quaternion> q(header.count);
+    toQuaternion(sequence, angles.data(), angles.size(), convention, q.data(), pool);
+    std::memcpy(results, q.data(), q.size() * sizeof(Quaternion));
+  }
+}
+
+/**
+ * @brief Writes a whole buffer to a blocking socket
+ */
+bool sendAll(int socket, const char* data, std::size_t size) {
+  while (size > 0) {
+    const ssize_t n = ::send(socket, data, size, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    } else if (n <= 0) {
+      return false;
+    }
+    data += n;
+    size -= n;
+  }
+  return true;
+}
+
+/**
+ * @brief Reads a whole buffer from a blocking socket
+ */
+bool receiveAll(int socket, char* data, std::size_t size) {
+  while (size > 0) {
+    const ssize_t n = ::recv(socket, data, size, 0);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    } else if (n <= 0) {
+      return false;
+    }
+    data += n;
+    size -= n;
+  }
+  return true;
+}
+
+}  // namespace
+
+/**
+ * @brief Buffers of one client connection
+ */
+struct Server::Connection {
+  explicit Connection(int socket) : socket(socket) {}
+
+  int socket;
+  std::vector<char> in;      ///< Received bytes not yet part of a complete request
+  std::vector<char> out;     ///< Responses not yet sent
+  std::size_t sent = 0;      ///< Bytes of out already sent
+  bool closing = false;      ///< Close once out has been sent
+};
+
+Server::Server(ThreadPool& pool) : pool_(pool) {
+  if (::pipe(wake_) == 0) {
+    for (const int fd : wake_) {
+      ::fcntl(fd, F_SETFL, O_NONBLOCK);
+      ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+  }
+}
+
+Server::~Server() {
+  for (auto connection : connections_) {
+    ::close(connection->socket);
+    delete connection;
+  }
+  if (listener_ != -1) {
+    ::close(listener_);
+    ::unlink(path_.c_str());
+  }
+  for (const int fd : wake_) {
+    if (fd != -1) {
+      ::close(fd);
+    }
+  }
+}
+
+bool Server::listen(const std::string& path) {
+  sockaddr_un addr;
+  if (!address(path, addr) || wake_[0] == -1) {
+    return false;
+  }
+  listener_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (listener_ == -1) {
+    return false;
+  }
+  if (!removeStaleSocket(path, addr)) {
+    ::close(listener_);
+    listener_ = -1;
+    return false;
+  }
+  if (::bind(listener_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+      ::listen(listener_, SOMAXCONN) != 0) {
+    ::close(listener_);
+    listener_ = -1;
+    return false;
+  }
+  path_ = path;
+  return true;
+}
+
+void Server::run() {
+  std::vector<pollfd> fds;
+  while (true) {
+    // Connections with responses waiting to be sent are not read, which pushes back on clients
+    fds.assign({{wake_[0], POLLIN, 0}, {listener_, POLLIN, 0}});
+    for (const auto connection : connections_) {
+      const bool pending = connection->sent < connection->out.size();
+      const short events = pending ? POLLOUT : (connection->closing ? 0 : POLLIN);
+      fds.push_back({connection->socket, events, 0});
+    }
+    if (::poll(fds.data(), fds.size(), -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    if (fds[0].revents != 0) {
+      break;
+    }
+
+    // Serve the connections that were polled, then accept new ones
+    std::vector<Connection*> open;
+    for (std::size_t i = 0; i < connections_.size(); ++i) {
+      Connection* connection = connections_[i];
+      const short revents = fds[i + 2].revents;
+      bool alive = true;
+      if (revents & (POLLIN | POLLHUP | POLLERR)) {
+        alive = receive(*connection);
+      }
+      if (alive && (revents & (POLLIN | POLLOUT | POLLHUP | POLLERR))) {
+        alive = send(*connection);
+      }
+      if (alive) {
+        open.push_back(connection);
+      } else {
+        ::close(connection->socket);
+        delete connection;
+      }
+    }
+    connections_.swap(open);
+
+    if (fds[1].revents & POLLIN) {
+      while (true) {
+        const int socket = ::accept4(listener_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (socket == -1) {
+          break;
+        }
+        connections_.push_back(new Connection(socket));
+      }
+    }
+  }
+
+  // Drain the wake-up pipe so that run can be called again
+  char byte;
+  while (::read(wake_[0], &byte, 1) == 1) {
+  }
+}
+
+void Server::stop() {
+  const char byte = 0;
+  const ssize_t written = ::write(wake_[1], &byte, 1);
+  static_cast<void>(written);
+}
+
+bool Server::receive(Connection& connection) {
+  // Read everything that has arrived
+  std::vector<char>& in = connection.in;
+  while (true) {
+    const std::size_t size = in.size();
+    in.resize(size + RECEIVE_SIZE);
+    const ssize_t n = ::recv(connection.socket, in.data() + size, RECEIVE_SIZE, 0);
+    in.resize(size + std::max<ssize_t>(n, 0));
+    if (n == 0) {
+      // The client has finished sending; answer what it sent, then close
+      connection.closing = true;
+      break;
+    } else if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        break;
+      }
+      return false;
+    }
+  }
+
+  // Answer every complete request
+  std::size_t offset = 0;
+  while (in.size() - offset >= sizeof(RequestHeader)) {
+    RequestHeader header;
+    std::memcpy(&header, in.data() + offset, sizeof(header));
+    if (header.magic != protocol::MAGIC || header.version != protocol::VERSION) {
+      respond(connection.out, Status::INVALID_HEADER, 0, 0);
+      connection.closing = true;
+      break;
+    } else if (header.count > protocol::MAX_COUNT) {
+      respond(connection.out, Status::TOO_LARGE, header.outputs, 0);
+      connection.closing = true;
+      break;
+    }
+
+    const std::size_t size = sizeof(header) + header.count * sizeof(Angles);
+    if (in.size() - offset < size) {
+      break;
+    }
+    const std::uint8_t outputs = protocol::OUTPUT_MATRIX | protocol::OUTPUT_QUATERNION;
+    if (!isSequenceValid(Sequence(header.sequence, 3))) {
+      respond(connection.out, Status::INVALID_SEQUENCE, header.outputs, 0);
+    } else if (header.outputs == 0 || (header.outputs & ~outputs) != 0) {
+      respond(connection.out, Status::INVALID_OUTPUTS, header.outputs, 0);
+    } else {
+      convert(header, in.data() + offset + sizeof(header), pool_, connection.out);
+    }
+    offset += size;
+  }
+  in.erase(in.begin(), in.begin() + offset);
+  return true;
+}
+
+bool Server::send(Connection& connection) {
+  std::vector<char>& out = connection.out;
+  while (connection.sent < out.size()) {
+    const ssize_t n = ::send(connection.socket, out.data() + connection.sent,
+                             out.size() - connection.sent, MSG_NOSIGNAL);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+    connection.sent += n;
+  }
+  out.clear();
+  connection.sent = 0;
+  return !connection.closing;
+}
+
+Client::~Client() { close(); }
+
+bool Client::connect(const std::string& path) {
+  close();
+  sockaddr_un addr;
+  if (!address(path, addr)) {
+    return false;
+  }
+  socket_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (socket_ == -1 || ::connect(socket_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+void Client::close() {
+  if (socket_ != -1) {
+    ::close(socket_);
+    socket_ = -1;
+  }
+}
+
+protocol::Status Client::convert(Sequence sequence, const Angles* angles,
+                                 std::size_t count, Convention convention, RotationMatrix* R,
+                                 Quaternion* q) {
+  // The count field has 32 bits, and the server would close the connection anyway
+  if (count > protocol::MAX_COUNT) {
+    return Status::TOO_LARGE;
+  }
+
+  RequestHeader request;
+  std::memcpy(request.sequence, sequence.valid() ? sequence.name() : "???", 3);
+  request.order = convention.order == Order::EXTRINSIC;
+  request.direction = convention.direction == Direction::PASSIVE;
+  request.outputs = (R != nullptr ? protocol::OUTPUT_MATRIX : 0) |
+                    (q != nullptr ? protocol::OUTPUT_QUATERNION : 0);
+  request.count = static_cast<std::uint32_t>(count);
+
+  buffer_.resize(sizeof(request) + count * sizeof(Angles));
+  std::memcpy(buffer_.data(), &request, sizeof(request));
+  std::memcpy(buffer_.data() + sizeof(request), angles, count * sizeof(Angles));
+  ResponseHeader response;
+  if (socket_ == -1 || !sendAll(socket_, buffer_.data(), buffer_.size()) ||
+      !receiveAll(socket_, reinterpret_cast<char*>(&response), sizeof(response))) {
+    return Status::INVALID_HEADER;
+  }
+  if (response.status != Status::OK) {
+    return response.status;
+  }
+
+  const std::size_t result_size = protocol::resultSize(request.outputs);
+  buffer_.resize(response.count * result_size);
+  if (!receiveAll(socket_, buffer_.data(), buffer_.size())) {
+    return Status::INVALID_HEADER;
+  }
+  for (std::size_t i = 0; i < response.count; ++i) {
+    const char* result = buffer_.data() + i * result_size;
+    if (R != nullptr) {
+      std::memcpy(&R[i], result, sizeof(RotationMatrix));
+      result += sizeof(RotationMatrix);
+    }
+    if (q != nullptr) {
+      std::memcpy(&q[i], result, sizeof(Quaternion));
+    }
+  }
+  return Status::OK;
+}
+
+}  // namespace euler
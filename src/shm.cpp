@@ -0,0 +1,245 @@
+#include <euler/shm.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <thread>
+
+namespace euler {
+namespace {  // anonymous
+
+/// First four bytes of a ring file ("EULS" in memory)
+const std::uint32_t MAGIC = 0x534c5545;
+
+/// Version of the layout of ring files
+const std::uint32_t VERSION = 3;
+
+/// Smallest number of slots, so that the states of one lap of a slot never reach the next lap
+const std::size_t MIN_CAPACITY = 4;
+
+// Atomics shared between processes must not fall back to a lock local to one process
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_LONG_LOCK_FREE == 2,
+              "Shared rings need lock-free 64-bit atomics");
+
+/**
+ * @brief Removes the file at path if it holds a ring
+ *
+ * @return True if nothing is left at path, false if it holds anything else
+ */
+bool removeRing(const std::string& path) {
+  MappedFile file;
+  if (!file.openRead(path)) {
+    return errno == ENOENT;
+  }
+  std::uint32_t magic = 0;
+  if (file.size() >= sizeof(magic)) {
+    std::memcpy(&magic, file.data(), sizeof(magic));
+  }
+  file.close();
+  return magic == MAGIC && std::remove(path.c_str()) == 0;
+}
+
+}  // namespace
+
+/**
+ * @brief Start of a ring file, followed by its slots
+ */
+struct SharedRing::Header {
+  std::atomic<std::uint32_t> magic;  ///< Written last, once the ring is ready
+  std::uint32_t version;
+  std::uint64_t capacity;
+  alignas(64) std::atomic<std::uint64_t> tail;  ///< Next ticket to hand out (producers)
+  alignas(64) std::atomic<std::uint64_t> head;  ///< Next ticket to convert (worker)
+};
+
+/**
+ * @brief One request and its result
+ *
+ * @details For the ticket t of its current lap, the state of a slot is t while the slot is free,
+ * t + 1 once the request is written and t + 2 once the result is written. Collecting the result
+ * sets it to t + capacity, the ticket of the next lap.
+ */
+struct alignas(64) SharedRing::Slot {
+  std::atomic<std::uint64_t> state;
+  Angles angles;
+  ConventionCode code;
+  SharedStatus status;
+  RotationMatrix R;
+  Quaternion q;
+};
+
+SharedRing::~SharedRing() { close(); }
+
+bool SharedRing::create(const std::string& path, std::size_t capacity) {
+  close();
+  std::size_t size = MIN_CAPACITY;
+  while (size < capacity) {
+    size *= 2;
+  }
+  if (!removeRing(path) || !file_.create(path, sizeof(Header) + size * sizeof(Slot), true)) {
+    return false;
+  }
+
+  // The new file is zero-filled, so producers reject it until the magic number is written last
+  header_ = new (file_.data()) Header;
+  header_->version = VERSION;
+  header_->capacity = size;
+  header_->tail.store(0, std::memory_order_relaxed);
+  header_->head.store(0, std::memory_order_relaxed);
+  slots_ = reinterpret_cast<Slot*>(file_.data() + sizeof(Header));
+  for (std::size_t i = 0; i < size; ++i) {
+    new (&slots_[i]) Slot;
+    slots_[i].state.store(i, std::memory_order_relaxed);
+  }
+  mask_ = size - 1;
+  stopped_.store(false, std::memory_order_relaxed);
+  header_->magic.store(MAGIC, std::memory_order_release);
+  return true;
+}
+
+bool SharedRing::open(const std::string& path) {
+  close();
+  if (!file_.openShared(path) || file_.size() < sizeof(Header)) {
+    close();
+    return false;
+  }
+
+  const auto header = reinterpret_cast<Header*>(file_.data());
+  if (header->magic.load(std::memory_order_acquire) != MAGIC) {
+    close();
+    return false;
+  }
+  const std::uint64_t capacity = header->capacity;
+  if (header->version != VERSION || capacity < MIN_CAPACITY || (capacity & (capacity - 1)) != 0 ||
+      file_.size() != sizeof(Header) + capacity * sizeof(Slot)) {
+    close();
+    return false;
+  }
+
+  header_ = header;
+  slots_ = reinterpret_cast<Slot*>(file_.data() + sizeof(Header));
+  mask_ = capacity - 1;
+  return true;
+}
+
+void SharedRing::close() {
+  file_.close();
+  header_ = nullptr;
+  slots_ = nullptr;
+  mask_ = 0;
+}
+
+bool SharedRing::trySubmit(Sequence sequence, const Angles& angles, Convention convention,
+                           std::uint64_t& ticket) {
+  std::uint64_t t = header_->tail.load(std::memory_order_relaxed);
+  for (;;) {
+    const std::uint64_t state = slots_[t & mask_].state.load(std::memory_order_acquire);
+    const auto lag = static_cast<std::int64_t>(state - t);
+    if (lag == 0) {
+      if (header_->tail.compare_exchange_weak(t, t + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (lag < 0) {
+      // The slot still holds the request of the previous lap
+      return false;
+    } else {
+      // Another producer claimed the slot first
+      t = header_->tail.load(std::memory_order_relaxed);
+    }
+  }
+
+  Slot& slot = slots_[t & mask_];
+  slot.angles = angles;
+  slot.code = ConventionCode(sequence, convention);
+  slot.state.store(t + 1, std::memory_order_release);
+  ticket = t;
+  return true;
+}
+
+std::uint64_t SharedRing::submit(Sequence sequence, const Angles& angles,
+                                 Convention convention) {
+  std::uint64_t ticket;
+  while (!trySubmit(sequence, angles, convention, ticket)) {
+    std::this_thread::yield();
+  }
+  return ticket;
+}
+
+SharedStatus SharedRing::tryCollect(std::uint64_t ticket, RotationMatrix& R, Quaternion& q) {
+  Slot& slot = slots_[ticket & mask_];
+  if (slot.state.load(std::memory_order_acquire) != ticket + 2) {
+    return SharedStatus::PENDING;
+  }
+  const SharedStatus status = slot.status;
+  if (status == SharedStatus::OK) {
+    R = slot.R;
+    q = slot.q;
+  }
+  slot.state.store(ticket + mask_ + 1, std::memory_order_release);
+  return status;
+}
+
+SharedStatus SharedRing::collect(std::uint64_t ticket, RotationMatrix& R, Quaternion& q) {
+  SharedStatus status;
+  while ((status = tryCollect(ticket, R, q)) == SharedStatus::PENDING) {
+    std::this_thread::yield();
+  }
+  return status;
+}
+
+SharedStatus SharedRing::convert(Sequence sequence, const Angles& angles,
+                                 Convention convention, RotationMatrix& R, Quaternion& q) {
+  return collect(submit(sequence, angles, convention), R, q);
+}
+
+std::size_t SharedRing::process() {
+  // Requests are converted in ticket order, up to the first one that is not written yet
+  const std::uint64_t head = header_->head.load(std::memory_order_relaxed);
+  std::size_t ready = 0;
+  while (ready <= mask_ &&
+         slots_[(head + ready) & mask_].state.load(std::memory_order_acquire) == head + ready + 1) {
+    ++ready;
+  }
+
+  // Every valid request is converted in one batch, whatever its sequence and convention
+  angles_.clear();
+  codes_.clear();
+  for (std::size_t i = 0; i < ready; ++i) {
+    const Slot& slot = slots_[(head + i) & mask_];
+    if (slot.code.valid()) {
+      angles_.push_back(slot.angles);
+      codes_.push_back(slot.code);
+    }
+  }
+  R_.resize(angles_.size());
+  q_.resize(angles_.size());
+  toRotationMatrix(codes_.data(), angles_.data(), angles_.size(), R_.data());
+  toQuaternion(codes_.data(), angles_.data(), angles_.size(), q_.data());
+
+  for (std::size_t i = 0, converted = 0; i < ready; ++i) {
+    Slot& slot = slots_[(head + i) & mask_];
+    if (slot.code.valid()) {
+      slot.R = R_[converted];
+      slot.q = q_[converted];
+      slot.status = SharedStatus::OK;
+      ++converted;
+    } else {
+      slot.status = SharedStatus::INVALID_CONVENTION;
+    }
+    slot.state.store(head + i + 2, std::memory_order_release);
+  }
+  header_->head.store(head + ready, std::memory_order_relaxed);
+  return ready;
+}
+
+void SharedRing::run() {
+  while (!stopped_.load(std::memory_order_acquire)) {
+    if (process() == 0) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+}  // namespace euler
@@ -0,0 +1,228 @@
+#include <euler/sincos.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// The wider variants are compiled with per-function target attributes and selected at runtime
+#if defined(EULER_RUNTIME_DISPATCH) && defined(__GNUC__) && defined(__x86_64__)
+#define EULER_X86_DISPATCH
+#endif
+
+namespace euler {
+namespace {  // anonymous
+
+#if defined(__GNUC__)
+
+#define EULER_ALWAYS_INLINE inline __attribute__((always_inline))
+
+typedef double double2 __attribute__((vector_size(2 * sizeof(double))));
+typedef double double4 __attribute__((vector_size(4 * sizeof(double))));
+typedef double double8 __attribute__((vector_size(8 * sizeof(double))));
+
+// Adding and subtracting 1.5 * 2^52 rounds a double to the nearest integer
+const double ROUND = 6755399441055744.0;
+
+// pi/2 split into three 33-bit parts (exact when multiplied by n < 2^20) and their tails, from
+// fdlibm's e_rem_pio2.c
+const double INV_PIO2 = 6.36619772367581382433e-01;
+const double PIO2_1 = 1.57079632673412561417e+00;
+const double PIO2_2 = 6.07710050630396597660e-11;
+const double PIO2_2T = 2.02226624879595063154e-21;
+const double PIO2_3 = 2.02226624871116645580e-21;
+const double PIO2_3T = 8.47842766036889956997e-32;
+
+// Minimax polynomials for sin and cos on [-pi/4, pi/4], from fdlibm's k_sin.c and k_cos.c
+const double S1 = -1.66666666666666324348e-01;
+const double S2 = 8.33333333332248946124e-03;
+const double S3 = -1.98412698298579493134e-04;
+const double S4 = 2.75573137070700676789e-06;
+const double S5 = -2.50507602534068634195e-08;
+const double S6 = 1.58969099521155010221e-10;
+const double C1 = 4.16666666666666019037e-02;
+const double C2 = -1.38888888888741095749e-03;
+const double C3 = 2.48015872894767294178e-05;
+const double C4 = -2.75573143513906633035e-07;
+const double C5 = 2.08757232129817482790e-09;
+const double C6 = -1.13596475577881948265e-11;
+
+/**
+ * @brief Computes the sine and cosine of every lane of a vector of angles
+ *
+ * @details Assumes every angle has magnitude at most SINCOS_MAX_REDUCED_ANGLE. The statements
+ * mirror fdlibm and must not be reassociated, so this relies on floating point contraction and
+ * fast math being disabled. Always inlined so that it is compiled for the ISA of its caller.
+ */
+template <typename V>
+EULER_ALWAYS_INLINE void sincosLanes(const V& x, V& s, V& c) {
+  // n = round(x / (pi/2)) and q = n mod 4, both as doubles
+  const V n = (x * INV_PIO2 + ROUND) - ROUND;
+  const V q = n - 4.0 * (((n * 0.25 - 0.375) + ROUND) - ROUND);
+
+  // x - n * pi/2 = y0 + y1 in double-double precision
+  V r = x - n * PIO2_1;
+  V t = r;
+  V w = n * PIO2_2;
+  r = t - w;
+  w = n * PIO2_2T - ((t - r) - w);
+  t = r;
+  w = n * PIO2_3;
+  r = t - w;
+  w = n * PIO2_3T - ((t - r) - w);
+  const V y0 = r - w;
+  const V y1 = (r - y0) - w;
+
+  // sin(y0 + y1) and cos(y0 + y1)
+  const V z = y0 * y0;
+  const V v = z * y0;
+  const V p_s = S2 + z * (S3 + z * (S4 + z * (S5 + z * S6)));
+  const V sin_r = y0 - ((z * (0.5 * y1 - v * p_s) - y1) - v * S1);
+  const V p_c = z * (C1 + z * (C2 + z * (C3 + z * (C4 + z * (C5 + z * C6)))));
+  const V hz = 0.5 * z;
+  const V one_minus_hz = 1.0 - hz;
+  const V cos_r = one_minus_hz + (((1.0 - one_minus_hz) - hz) + (z * p_c - y0 * y1));
+
+  // Undo the reduction by quadrant
+  const auto swap = (q == 1.0) | (q == 3.0);
+  const auto sin_negative = q >= 2.0;
+  const auto cos_negative = (q == 1.0) | (q == 2.0);
+  s = swap ? cos_r : sin_r;
+  c = swap ? sin_r : cos_r;
+  s = sin_negative ? -s : s;
+  c = cos_negative ? -c : c;
+}
+
+template <typename V>
+EULER_ALWAYS_INLINE void sincosVectorized(const double* angles, std::size_t count, double* sines,
+                                          double* cosines) {
+  const std::size_t W = sizeof(V) / sizeof(double);
+
+  // Full vectors first, then the remainder padded with zeros
+  std::size_t i = 0;
+  for (; i + W <= count; i += W) {
+    V x, s, c;
+    std::memcpy(&x, angles + i, sizeof(V));
+    sincosLanes(x, s, c);
+    std::memcpy(sines + i, &s, sizeof(V));
+    std::memcpy(cosines + i, &c, sizeof(V));
+  }
+  if (i < count) {
+    V x = {}, s, c;
+    std::memcpy(&x, angles + i, (count - i) * sizeof(double));
+    sincosLanes(x, s, c);
+    std::memcpy(sines + i, &s, (count - i) * sizeof(double));
+    std::memcpy(cosines + i, &c, (count - i) * sizeof(double));
+  }
+
+  // Angles the reduction cannot handle (including infinities and NaN) go to libm
+  for (i = 0; i < count; ++i) {
+    if (!(std::abs(angles[i]) <= SINCOS_MAX_REDUCED_ANGLE)) {
+      sines[i] = std::sin(angles[i]);
+      cosines[i] = std::cos(angles[i]);
+    }
+  }
+}
+
+void sincosBaseline(const double* angles, std::size_t count, double* sines, double* cosines) {
+  sincosVectorized<double2>(angles, count, sines, cosines);
+}
+
+#if defined(EULER_X86_DISPATCH)
+__attribute__((target("avx2,fma"))) void sincosAvx2(const double* angles, std::size_t count,
+                                                     double* sines, double* cosines) {
+  sincosVectorized<double4>(angles, count, sines, cosines);
+}
+
+__attribute__((target("avx512f"))) void sincosAvx512(const double* angles, std::size_t count,
+                                                      double* sines, double* cosines) {
+  sincosVectorized<double8>(angles, count, sines, cosines);
+}
+#endif
+
+#endif
+
+void sincosScalar(const double* angles, std::size_t count, double* sines, double* cosines) {
+  for (std::size_t i = 0; i < count; ++i) {
+    sines[i] = std::sin(angles[i]);
+    cosines[i] = std::cos(angles[i]);
+  }
+}
+
+SimdLevel detectSimdLevel() {
+#if defined(EULER_X86_DISPATCH)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return SimdLevel::AVX512;
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return SimdLevel::AVX2;
+  }
+#endif
+#if defined(__GNUC__)
+  return SimdLevel::BASELINE;
+#else
+  return SimdLevel::SCALAR;
+#endif
+}
+
+SimdLevel selectSimdLevel() {
+  // The EULER_SIMD environment variable can lower (but never raise) the detected level
+  const SimdLevel supported = supportedSimdLevel();
+  const char* requested = std::getenv("EULER_SIMD");
+  if (requested == nullptr) {
+    return supported;
+  }
+
+  const std::string name = requested;
+  SimdLevel level = supported;
+  if (name == "scalar") {
+    level = SimdLevel::SCALAR;
+  } else if (name == "baseline") {
+    level = SimdLevel::BASELINE;
+  } else if (name == "avx2") {
+    level = SimdLevel::AVX2;
+  } else if (name == "avx512") {
+    level = SimdLevel::AVX512;
+  }
+  return level < supported ? level : supported;
+}
+}  // namespace
+
+SimdLevel supportedSimdLevel() {
+  static const SimdLevel level = detectSimdLevel();
+  return level;
+}
+
+SimdLevel simdLevel() {
+  static const SimdLevel level = selectSimdLevel();
+  return level;
+}
+
+void sincos(const double* angles, std::size_t count, double* sines, double* cosines) {
+  sincos(angles, count, sines, cosines, simdLevel());
+}
+
+void sincos(const double* angles, std::size_t count, double* sines, double* cosines,
+            SimdLevel level) {
+  switch (level) {
+#if defined(EULER_X86_DISPATCH)
+    case SimdLevel::AVX512:
+      sincosAvx512(angles, count, sines, cosines);
+      break;
+    case SimdLevel::AVX2:
+      sincosAvx2(angles, count, sines, cosines);
+      break;
+#endif
+#if defined(__GNUC__)
+    case SimdLevel::BASELINE:
+      sincosBaseline(angles, count, sines, cosines);
+      break;
+#endif
+    default:
+      sincosScalar(angles, count, sines, cosines);
+      break;
+  }
+}
+
+}  // namespace euler
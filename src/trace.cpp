@@ -0,0 +1,145 @@
+#include <euler/trace.h>
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <unistd.h>
+#include <vector>
+
+namespace euler {
+namespace {  // anonymous
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief An event that ran on a thread from start to start + duration
+ */
+struct Event {
+  const char* name;
+  const char* category;
+  Clock::time_point start;
+  Clock::duration duration;
+  std::size_t records;
+};
+
+/**
+ * @brief The events recorded by one thread, which only that thread appends to
+ */
+struct ThreadEvents {
+  std::size_t id;
+  std::string name;
+  std::vector<Event> events;
+};
+
+std::atomic<bool> enabled(false);
+Clock::time_point origin;
+
+// Buffers are kept until the program exits, so that threads can hold on to theirs across traces
+std::mutex registry_mutex;
+std::vector<std::unique_ptr<ThreadEvents>> registry;
+
+thread_local ThreadEvents* local = nullptr;
+thread_local std::string local_name;
+
+ThreadEvents& threadEvents() {
+  if (local == nullptr) {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    registry.emplace_back(new ThreadEvents);
+    local = registry.back().get();
+    local->id = registry.size();
+    local->name = local_name.empty() ? "thread " + std::to_string(local->id) : local_name;
+  }
+  return *local;
+}
+
+/**
+ * @brief Writes a string as a JSON string literal
+ */
+void writeString(std::FILE* file, const std::string& s) {
+  std::fputc('"', file);
+  for (const char c : s) {
+    if (c == '"' || c == '\\') {
+      std::fputc('\\', file);
+      std::fputc(c, file);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      std::fprintf(file, "\\u%04x", c);
+    } else {
+      std::fputc(c, file);
+    }
+  }
+  std::fputc('"', file);
+}
+
+double microseconds(Clock::duration d) {
+  return std::chrono::duration<double, std::micro>(d).count();
+}
+
+}  // namespace
+
+void startTrace() {
+#if EULER_INSTRUMENTATION
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  for (auto& thread : registry) {
+    thread->events.clear();
+  }
+  origin = Clock::now();
+  enabled.store(true, std::memory_order_release);
+#endif
+}
+
+void stopTrace() { enabled.store(false, std::memory_order_release); }
+
+bool tracing() { return enabled.load(std::memory_order_relaxed); }
+
+void setTraceThreadName(const std::string& name) {
+  local_name = name;
+  if (local != nullptr) {
+    local->name = name;
+  }
+}
+
+void traceEvent(const char* name, const char* category, Clock::time_point start,
+                Clock::time_point end, std::size_t records) {
+  if (tracing()) {
+    threadEvents().events.push_back({name, category, start, end - start, records});
+  }
+}
+
+bool writeTrace(const std::string& path) {
+  std::FILE* file = std::fopen(path.c_str(), "w");
+  if (file == nullptr) {
+    return false;
+  }
+
+  // Complete ("X") events with times in microseconds, and the names of threads as metadata
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  const long pid = ::getpid();
+  std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+  const char* separator = "\n";
+  for (const auto& thread : registry) {
+    std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%ld,\"tid\":%zu,"
+                 "\"args\":{\"name\":", separator, pid, thread->id);
+    writeString(file, thread->name);
+    std::fprintf(file, "}}");
+    separator = ",\n";
+    for (const auto& event : thread->events) {
+      std::fprintf(file, ",\n{\"name\":");
+      writeString(file, event.name);
+      std::fprintf(file, ",\"cat\":");
+      writeString(file, event.category);
+      std::fprintf(file, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%ld,\"tid\":%zu",
+                   microseconds(event.start - origin), microseconds(event.duration), pid,
+                   thread->id);
+      if (event.records != 0) {
+        std::fprintf(file, ",\"args\":{\"records\":%zu}", event.records);
+      }
+      std::fprintf(file, "}");
+    }
+  }
+  std::fprintf(file, "\n]}\n");
+  const bool written = std::ferror(file) == 0;
+  return std::fclose(file) == 0 && written;
+}
+
+}  // namespace euler
@@ -0,0 +1,89 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <euler/binary.h>
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace euler;
+
+TEST_CASE("Binary records") {
+  std::mt19937_64 generator(11);
+  std::uniform_real_distribution<double> distribution(-M_PI, M_PI);
+  std::vector<Angles> angles(1000);
+  for (auto& a : angles) {
+    a = {distribution(generator), distribution(generator), distribution(generator)};
+  }
+
+  const std::array<Sequence, 3> sequences = {"zyx", "xzx", "yxz"};
+  const std::array<Convention, 2> conventions = {
+      Convention(Order::INTRINSIC, Direction::ACTIVE),
+      Convention(Order::EXTRINSIC, Direction::PASSIVE)};
+  for (const auto& sequence : sequences) {
+    for (const auto& convention : conventions) {
+      std::vector<BinaryRecord> records(angles.size());
+      toBinaryRecords(sequence, angles.data(), angles.size(), convention, records.data());
+
+      std::vector<RotationMatrix> R(angles.size());
+      std::vector<Quaternion> q(angles.size());
+      toRotationMatrix(sequence, angles.data(), angles.size(), convention, R.data());
+      toQuaternion(sequence, angles.data(), angles.size(), convention, q.data());
+      for (std::size_t i = 0; i < angles.size(); ++i) {
+        REQUIRE(records[i].R == R[i]);
+        REQUIRE(records[i].q == q[i]);
+      }
+    }
+  }
+}
+
+TEST_CASE("Mapped files") {
+  const std::string path = "test_binary_mapped.bin";
+  const std::array<double, 5> values = {1.5, -2.25, 0.0, 1e-300, 42.0};
+
+  SUBCASE("Create and read back") {
+    {
+      MappedFile file;
+      REQUIRE(file.create(path, sizeof(values)));
+      CHECK(file.isOpen());
+      REQUIRE(file.size() == sizeof(values));
+      std::memcpy(file.data(), values.data(), sizeof(values));
+    }
+
+    MappedFile file;
+    REQUIRE(file.openRead(path));
+    REQUIRE(file.size() == sizeof(values));
+    CHECK(std::memcmp(file.data(), values.data(), sizeof(values)) == 0);
+
+    MappedFile moved(std::move(file));
+    CHECK(!file.isOpen());
+    CHECK(file.data() == nullptr);
+    REQUIRE(moved.isOpen());
+    CHECK(std::memcmp(moved.data(), values.data(), sizeof(values)) == 0);
+
+    moved.close();
+    CHECK(!moved.isOpen());
+    CHECK(moved.size() == 0);
+  }
+
+  SUBCASE("Empty file") {
+    MappedFile file;
+    REQUIRE(file.create(path, 0));
+    file.close();
+    REQUIRE(file.openRead(path));
+    CHECK(file.size() == 0);
+    CHECK(file.data() == nullptr);
+  }
+
+  SUBCASE("Missing file") {
+    MappedFile file;
+    CHECK(!file.openRead("does/not/exist.bin"));
+    CHECK(!file.isOpen());
+    CHECK(!file.create("does/not/exist.bin", 8));
+    CHECK(!file.isOpen());
+  }
+
+  std::remove(path.c_str());
+}
@@ -0,0 +1,86 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <euler/c_api.h>
+#include <euler/rotations.h>
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace euler;
+
+TEST_CASE("C interface") {
+  CHECK(euler_api_version() == EULER_C_API_VERSION);
+
+  const char* names[] = {"xyz", "xzy", "yxz", "yzx", "zxy", "zyx",
+                         "xyx", "xzx", "yxy", "yzy", "zxz", "zyz"};
+  for (int seq = EULER_XYZ; seq <= EULER_ZYZ; ++seq) {
+    CHECK(euler_parse_sequence(names[seq]) == seq);
+  }
+  CHECK(euler_parse_sequence("xxy") == EULER_INVALID_SEQUENCE);
+  CHECK(euler_parse_sequence("zyxz") == EULER_INVALID_SEQUENCE);
+  CHECK(euler_parse_sequence(nullptr) == EULER_INVALID_SEQUENCE);
+
+  std::mt19937_64 generator(7);
+  std::uniform_real_distribution<double> distribution(-M_PI, M_PI);
+  const std::size_t n = 300;
+  std::vector<double> angles(3 * n);
+  for (auto& x : angles) {
+    x = distribution(generator);
+  }
+
+  SUBCASE("Conversions match the C++ batch functions") {
+    const auto a = reinterpret_cast<const Angles*>(angles.data());
+    for (int seq = EULER_XYZ; seq <= EULER_ZYZ; ++seq) {
+      for (int conv = 0; conv < 4; ++conv) {
+        const Convention convention(conv & EULER_EXTRINSIC ? Order::EXTRINSIC : Order::INTRINSIC,
+                                    conv & EULER_PASSIVE ? Direction::PASSIVE : Direction::ACTIVE);
+        std::vector<RotationMatrix> R_expected(n);
+        std::vector<Quaternion> q_expected(n);
+        toRotationMatrix(names[seq], a, n, convention, R_expected.data());
+        toQuaternion(names[seq], a, n, convention, q_expected.data());
+
+        std::vector<double> R(9 * n), q(4 * n);
+        REQUIRE(euler_to_matrix_batch(angles.data(), n, seq, conv, R.data()) == EULER_OK);
+        REQUIRE(euler_to_quaternion_batch(angles.data(), n, seq, conv, q.data()) == EULER_OK);
+        CHECK(std::memcmp(R.data(), R_expected.data(), R.size() * sizeof(double)) == 0);
+        CHECK(std::memcmp(q.data(), q_expected.data(), q.size() * sizeof(double)) == 0);
+
+        std::vector<double> R_both(9 * n), q_both(4 * n);
+        REQUIRE(euler_to_matrix_quaternion_batch(angles.data(), n, seq, conv, R_both.data(),
+                                                 q_both.data()) == EULER_OK);
+        CHECK(R_both == R);
+        CHECK(q_both == q);
+
+        std::vector<Angles> from_R(n), from_q(n);
+        toEulerAngles(R_expected.data(), n, names[seq], convention, from_R.data());
+        toEulerAngles(q_expected.data(), n, names[seq], convention, from_q.data());
+        std::vector<double> out(3 * n);
+        REQUIRE(euler_matrix_to_angles_batch(R.data(), n, seq, conv, out.data()) == EULER_OK);
+        CHECK(std::memcmp(out.data(), from_R.data(), out.size() * sizeof(double)) == 0);
+        REQUIRE(euler_quaternion_to_angles_batch(q.data(), n, seq, conv, out.data()) == EULER_OK);
+        CHECK(std::memcmp(out.data(), from_q.data(), out.size() * sizeof(double)) == 0);
+      }
+    }
+  }
+
+  SUBCASE("Invalid arguments") {
+    std::vector<double> out(9 * n, 0.0);
+    CHECK(euler_to_matrix_batch(angles.data(), n, -1, 0, out.data()) == EULER_INVALID_SEQUENCE);
+    CHECK(euler_to_matrix_batch(angles.data(), n, 12, 0, out.data()) == EULER_INVALID_SEQUENCE);
+    CHECK(euler_to_quaternion_batch(angles.data(), n, EULER_ZYX, 4, out.data()) ==
+          EULER_INVALID_CONVENTION);
+    CHECK(euler_to_matrix_batch(nullptr, n, EULER_ZYX, 0, out.data()) == EULER_INVALID_POINTER);
+    CHECK(euler_matrix_to_angles_batch(out.data(), n, EULER_ZYX, 0, nullptr) ==
+          EULER_INVALID_POINTER);
+    CHECK(euler_to_matrix_quaternion_batch(angles.data(), n, EULER_ZYX, 0, out.data(), nullptr) ==
+          EULER_INVALID_POINTER);
+    CHECK(out == std::vector<double>(9 * n, 0.0));
+
+    // Nothing is read or written for empty batches
+    CHECK(euler_to_matrix_batch(nullptr, 0, EULER_ZYX, 0, nullptr) == EULER_OK);
+    CHECK(euler_to_matrix_quaternion_batch(nullptr, 0, EULER_ZYX, 0, nullptr, nullptr) ==
+          EULER_OK);
+  }
+}
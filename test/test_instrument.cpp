@@ -0,0 +1,67 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <euler/instrument.h>
+#include <euler/rotations.h>
+
+#include <string>
+#include <vector>
+
+using namespace euler;
+
+TEST_CASE("Probes") {
+  resetProbes();
+  const std::vector<Angles> angles(300, Angles{0.1, -0.2, 0.3});
+  std::vector<RotationMatrix> R(angles.size());
+  std::vector<Quaternion> q(angles.size());
+  const Convention convention(Order::INTRINSIC, Direction::ACTIVE);
+
+  SUBCASE("Batch conversions are counted") {
+    toRotationMatrix("zyx", angles.data(), angles.size(), convention, R.data());
+    toRotationMatrix("xzx", angles.data(), PROBE_MIN_RECORDS, convention, R.data());
+    toQuaternion("zyx", angles.data(), angles.size(), convention, q.data());
+
+    // Single conversions and small batches are not
+    toRotationMatrix("zyx", angles[0], convention);
+    toRotationMatrix("zyx", angles.data(), 1, convention, R.data());
+    toQuaternion("zyx", angles.data(), PROBE_MIN_RECORDS - 1, convention, q.data());
+
+    const ProbeTotals matrices = probeTotals(Probe::ROTATION_MATRIX);
+    const ProbeTotals quaternions = probeTotals(Probe::QUATERNION);
+    if (EULER_INSTRUMENTATION) {
+      CHECK(matrices.calls == 2);
+      CHECK(matrices.records == angles.size() + PROBE_MIN_RECORDS);
+      CHECK(quaternions.calls == 1);
+      CHECK(quaternions.records == angles.size());
+    } else {
+      CHECK(matrices.calls == 0);
+      CHECK(quaternions.records == 0);
+    }
+    CHECK(probeTotals(Probe::PARSE).calls == 0);
+  }
+
+  SUBCASE("Timers") {
+    {
+      ProbeTimer timer(Probe::FORMAT, PROBE_MIN_RECORDS);
+      timer.addRecords(7);
+    }
+    {
+      ProbeTimer timer(Probe::FORMAT);
+      timer.addRecords(5);
+    }
+    {
+      const ProbeTimer timer(Probe::FORMAT, PROBE_MIN_RECORDS - 1);
+    }
+    const ProbeTotals totals = probeTotals(Probe::FORMAT);
+    CHECK(totals.calls == (EULER_INSTRUMENTATION ? 2 : 0));
+    CHECK(totals.records == (EULER_INSTRUMENTATION ? PROBE_MIN_RECORDS + 12 : 0));
+  }
+
+  SUBCASE("Reset") {
+    addProbe(Probe::PARSE, 3, 1000);
+    resetProbes();
+    CHECK(probeTotals(Probe::PARSE).records == 0);
+  }
+
+  CHECK(std::string(probeName(Probe::ROTATION_MATRIX)) == "toRotationMatrix");
+}
@@ -4,6 +4,13 @@
 #include <euler/io.h>
 
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <vector>
 
 using namespace euler;
 
@@ -26,3 +33,239 @@ TEST_CASE("Sequence validity") {
     }
   }
 }
+
+/// Decimal digits of 5^n, which are the significant digits of 2^-n
+std::string powerOfFive(int n) {
+  std::vector<int> digits = {1};  // Least significant first
+  for (int i = 0; i < n; ++i) {
+    int carry = 0;
+    for (auto& d : digits) {
+      const int product = 5 * d + carry;
+      d = product % 10;
+      carry = product / 10;
+    }
+    if (carry > 0) {
+      digits.push_back(carry);
+    }
+  }
+  std::string text;
+  for (auto d = digits.rbegin(); d != digits.rend(); ++d) {
+    text += static_cast<char>('0' + *d);
+  }
+  return text;
+}
+
+double parse(const std::string& text, std::size_t& consumed, ParseError& error) {
+  double value = -123.0;
+  const ParseResult result = parseDouble(text.data(), text.data() + text.size(), value);
+  consumed = result.ptr - text.data();
+  error = result.error;
+  return value;
+}
+
+TEST_CASE("Parsing real numbers") {
+  std::size_t consumed;
+  ParseError error;
+
+  SUBCASE("Matches strtod") {
+    std::mt19937_64 generator(7);
+    std::uniform_real_distribution<double> uniform(-400.0, 400.0);
+    std::uniform_int_distribution<int> exponent(-320, 300);
+    const std::array<const char*, 5> formats = {"%.17g", "%.4f", "%.6e", "%.25g", "%.40f"};
+
+    char text[512];
+    for (int i = 0; i < 20000; ++i) {
+      const double x = i % 2 == 0 ? uniform(generator)
+                                  : uniform(generator) * std::pow(10.0, exponent(generator));
+      for (const auto format : formats) {
+        const int length = std::snprintf(text, sizeof(text), format, x);
+        const double expect = std::strtod(text, nullptr);
+        const double actual = parse(text, consumed, error);
+        REQUIRE(error == ParseError::NONE);
+        CHECK(consumed == static_cast<std::size_t>(length));
+        CHECK(actual == expect);
+      }
+    }
+  }
+
+  SUBCASE("Long and unusual numbers") {
+    const std::array<std::string, 10> texts = {
+        "0.1000000000000000055511151231257827021181583404541015625",
+        "2.4703282292062327208828439643411068618252990130716238221279284125033775363510437593264991"
+        "8186e-324",
+        "179769313486231580793728971405303415079934132710037826936173778980444968292764750946649017"
+        "977587207096330286416692887910946555547851940402630657488671505820681908902000708383676273"
+        "854845817711531764475730270069855571366959622842914819860834936475292719074168444365510704"
+        "342711559699508093042880177904174497791",
+        "123456789012345678901234567890",
+        "0.000000000000000000000000000000000000123",
+        "1e-400",
+        "-0",
+        "-0.0e10",
+        "9007199254740993",
+        "1.00000000000000000000000000000000000000000000000000000000000000000000000000000000001"};
+    for (const auto& text : texts) {
+      CHECK(parse(text, consumed, error) == std::strtod(text.c_str(), nullptr));
+      CHECK(error == ParseError::NONE);
+      CHECK(consumed == text.size());
+    }
+    CHECK(std::signbit(parse("-0", consumed, error)));
+  }
+
+  SUBCASE("Halfway points with hundreds of digits") {
+    // 2^-1075 is halfway between zero and the smallest subnormal, and has 753 significant digits
+    const std::string half = powerOfFive(1075);
+    const std::array<std::string, 3> texts = {half + "e-1075", half + "00000000001e-1086",
+                                              half.substr(0, half.size() - 1) + "e-1074"};
+    for (const auto& text : texts) {
+      CHECK(parse(text, consumed, error) == std::strtod(text.c_str(), nullptr));
+      CHECK(consumed == text.size());
+    }
+    CHECK(parse(texts[0], consumed, error) == 0.0);
+    CHECK(parse(texts[1], consumed, error) == std::numeric_limits<double>::denorm_min());
+  }
+
+  SUBCASE("Partial numbers") {
+    CHECK(parse("12.5abc", consumed, error) == 12.5);
+    CHECK(consumed == 4);
+    CHECK(parse("3e", consumed, error) == 3.0);
+    CHECK(consumed == 1);
+    CHECK(parse("3e+x", consumed, error) == 3.0);
+    CHECK(consumed == 1);
+    CHECK(parse("-.5 ", consumed, error) == -0.5);
+    CHECK(consumed == 3);
+    CHECK(parse("7.", consumed, error) == 7.0);
+    CHECK(consumed == 2);
+  }
+
+  SUBCASE("Invalid numbers") {
+    const std::array<std::string, 7> texts = {"", "-", ".", "-.", "+1", " 1", "abc"};
+    for (const auto& text : texts) {
+      CHECK(parse(text, consumed, error) == -123.0);
+      CHECK(error == ParseError::INVALID_NUMBER);
+      CHECK(consumed == 0);
+    }
+    parse("1e400", consumed, error);
+    CHECK(error == ParseError::OUT_OF_RANGE);
+  }
+}
+
+TEST_CASE("Parsing lines of angles") {
+  const std::string text =
+      "20 -10 35\n"
+      "  1.5,\t-2e1 , +3  \r\n"
+      "\n"
+      "1 2\n"
+      "1 2 3 4\n"
+      "1 2 x\n"
+      "1 2 3x\n"
+      "1 2 1e999\n"
+      "-0.25 0.5 .75";
+  const std::array<ParseError, 9> errors = {
+      ParseError::NONE,           ParseError::NONE,           ParseError::EMPTY_LINE,
+      ParseError::TOO_FEW_ANGLES, ParseError::TOO_MANY_ANGLES, ParseError::INVALID_NUMBER,
+      ParseError::INVALID_NUMBER, ParseError::OUT_OF_RANGE,   ParseError::NONE};
+
+  const char* p = text.data();
+  const char* last = text.data() + text.size();
+  std::vector<Angles> parsed;
+  for (const auto expect : errors) {
+    REQUIRE(p != last);
+    Angles angles;
+    const ParseResult result = parseAngles(p, last, angles);
+    CHECK(result.error == expect);
+    if (result.error == ParseError::NONE) {
+      parsed.push_back(angles);
+    }
+    p = result.ptr;
+  }
+  CHECK(p == last);
+
+  REQUIRE(parsed.size() == 3);
+  CHECK(parsed[0] == Angles{20, -10, 35});
+  CHECK(parsed[1] == Angles{1.5, -20, 3});
+  CHECK(parsed[2] == Angles{-0.25, 0.5, 0.75});
+}
+
+TEST_CASE("Formatting rotations") {
+  // The iostream formatting used before format existed
+  const auto reference = [](const std::array<double, 4>& q, const RotationMatrix& R) {
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(4);
+    os << "  w: " << std::setw(7) << q[0] << "\n"
+       << "  x: " << std::setw(7) << q[1] << "\n"
+       << "  y: " << std::setw(7) << q[2] << "\n"
+       << "  z: " << std::setw(7) << q[3] << "|";
+    for (int i = 0; i < 9; ++i) {
+      os << (i == 3 || i == 6 ? "\n" : "") << std::setw(8) << R[i];
+    }
+    os << "|";
+    for (int i = 0; i < 9; ++i) {
+      os << (i == 0 ? "" : " ") << R[i];
+    }
+    os << "|" << q[0] << " " << q[1] << " " << q[2] << " " << q[3];
+    return os.str();
+  };
+  const auto formatted = [](const Quaternion& q, const RotationMatrix& R) {
+    std::vector<char> buffer(4 * MAX_FORMAT_LENGTH);
+    char* p = format(buffer.data(), q);
+    *p++ = '|';
+    p = format(p, R);
+    *p++ = '|';
+    p = formatCompact(p, R);
+    *p++ = '|';
+    p = formatCompact(p, q);
+    return std::string(buffer.data(), p);
+  };
+  const auto check = [&](std::vector<double> values) {
+    values.resize((values.size() + 8) / 9 * 9);
+    for (std::size_t i = 0; i + 9 <= values.size(); i += 9) {
+      RotationMatrix R;
+      std::copy(values.begin() + i, values.begin() + i + 9, R.begin());
+      const Quaternion q = {R[0], R[4], R[8], R[2]};
+      REQUIRE(formatted(q, R) == reference(q, R));
+    }
+  };
+
+  SUBCASE("Random values") {
+    std::mt19937_64 generator(7);
+    std::uniform_real_distribution<double> unit(-1, 1);
+    std::uniform_real_distribution<double> exponent(-12, 8);
+    std::vector<double> values;
+    for (int i = 0; i < 90000; ++i) {
+      const double magnitude = std::pow(10, exponent(generator));
+      values.push_back(i % 2 == 0 ? unit(generator) : std::copysign(magnitude, unit(generator)));
+    }
+    check(values);
+  }
+
+  SUBCASE("Ties and special values") {
+    const double inf = std::numeric_limits<double>::infinity();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    check({0.0, -0.0, 1.0, -1.0, 0.00005, -0.00005, 0.00015, 1.03125, -2.5e-5,
+           0.99995, -0.99995, 0.999949999, 9.99995, 1e-300, -1e-300, 999999.99995, 1e6, -1e6, 1e300,
+           -1e300, inf, -inf, nan, -nan, 0.12345, 0.5, 0.00004999999999, 1.00005, 0.1});
+  }
+
+  SUBCASE("Longest numbers fit") {
+    RotationMatrix R;
+    R.fill(-std::numeric_limits<double>::max());
+    const Quaternion q = {R[0], R[1], R[2], R[3]};
+    check(std::vector<double>(R.begin(), R.end()));
+
+    std::vector<char> buffer(MAX_FORMAT_LENGTH);
+    CHECK(format(buffer.data(), R) - buffer.data() < std::ptrdiff_t(MAX_FORMAT_LENGTH));
+    CHECK(format(buffer.data(), q) - buffer.data() < std::ptrdiff_t(MAX_FORMAT_LENGTH));
+    CHECK(formatCompact(buffer.data(), R) - buffer.data() < std::ptrdiff_t(MAX_FORMAT_LENGTH));
+  }
+
+  SUBCASE("Operators") {
+    const RotationMatrix R = {0.9254, -0.3738, 0.0625, 0.3368, 0.7357, -0.5876, 0.1736, 0.5649,
+                              0.8067};
+    const Quaternion q = {0.9311, 0.3094, -0.0298, 0.1908};
+    std::ostringstream os;
+    os << q << "|" << R;
+    const std::string expected = reference(q, R);
+    CHECK(os.str() == expected.substr(0, expected.find('|', expected.find('|') + 1)));
+  }
+}
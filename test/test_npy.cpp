@@ -0,0 +1,147 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <euler/npy.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+using namespace euler;
+
+namespace {
+
+const std::string PATH = "test_npy_array.npy";
+
+/// Writes a .npy file by hand, with an arbitrary version, header and payload
+void writeFile(int major, const std::string& header, const void* data, std::size_t size) {
+  std::ofstream file(PATH, std::ios::binary);
+  file.write("\x93NUMPY", 6);
+  file.put(static_cast<char>(major));
+  file.put(0);
+  const std::size_t length = header.size() + 1;
+  for (int i = 0; i < (major == 1 ? 2 : 4); ++i) {
+    file.put(static_cast<char>((length >> (8 * i)) & 0xff));
+  }
+  file << header << '\n';
+  file.write(static_cast<const char*>(data), size);
+}
+
+}  // namespace
+
+TEST_CASE("Writing and reading arrays") {
+  std::vector<RotationMatrix> R(5);
+  std::vector<Quaternion> q(5);
+  for (std::size_t i = 0; i < R.size(); ++i) {
+    for (std::size_t j = 0; j < 9; ++j) {
+      R[i][j] = i + 0.1 * j;
+    }
+    q[i] = {double(i), -0.5, 0.25, 1e-300};
+  }
+
+  SUBCASE("Rotation matrices") {
+    REQUIRE(writeNpy(PATH, R.data(), R.size()) == NpyError::NONE);
+    NpyArray array;
+    REQUIRE(array.openRead(PATH) == NpyError::NONE);
+    CHECK(array.type() == NpyType::FLOAT64);
+    CHECK(!array.fortranOrder());
+    CHECK(array.shape() == std::vector<std::size_t>{5, 3, 3});
+    CHECK(reinterpret_cast<std::uintptr_t>(array.data()) % 64 == 0);
+    CHECK(std::memcmp(array.data(), R.data(), R.size() * sizeof(RotationMatrix)) == 0);
+    CHECK(checkAngles(array) == NpyError::INVALID_SHAPE);
+  }
+
+  SUBCASE("Quaternions") {
+    REQUIRE(writeNpy(PATH, q.data(), q.size()) == NpyError::NONE);
+    NpyArray array;
+    REQUIRE(array.openRead(PATH) == NpyError::NONE);
+    CHECK(array.shape() == std::vector<std::size_t>{5, 4});
+    CHECK(std::memcmp(array.data(), q.data(), q.size() * sizeof(Quaternion)) == 0);
+  }
+
+  SUBCASE("Empty and one-dimensional arrays") {
+    REQUIRE(writeNpy(PATH, q.data(), 0) == NpyError::NONE);
+    NpyArray array;
+    REQUIRE(array.openRead(PATH) == NpyError::NONE);
+    CHECK(array.shape() == std::vector<std::size_t>{0, 4});
+
+    REQUIRE(array.create(PATH, {7}) == NpyError::NONE);
+    REQUIRE(array.openRead(PATH) == NpyError::NONE);
+    CHECK(array.shape() == std::vector<std::size_t>{7});
+  }
+
+  std::remove(PATH.c_str());
+}
+
+TEST_CASE("Reading angles") {
+  const std::vector<Angles> expected = {{1, 2, 3}, {-4, 5.5, 6}, {0.25, -8, 9}};
+
+  SUBCASE("float64 in C order") {
+    writeFile(1, "{'descr': '<f8', 'fortran_order': False, 'shape': (3, 3), }", expected.data(),
+              sizeof(Angles) * expected.size());
+    NpyArray array;
+    REQUIRE(array.openRead(PATH) == NpyError::NONE);
+    REQUIRE(checkAngles(array) == NpyError::NONE);
+    std::vector<Angles> angles;
+    REQUIRE(readNpy(PATH, angles) == NpyError::NONE);
+    CHECK(angles == expected);
+  }
+
+  SUBCASE("float32 in Fortran order") {
+    const std::vector<float> columns = {1, -4, 0.25, 2, 5.5, -8, 3, 6, 9};
+    writeFile(2, "{'descr': '<f4', 'fortran_order': True, 'shape': (3, 3)}", columns.data(),
+              sizeof(float) * columns.size());
+    NpyArray array;
+    REQUIRE(array.openRead(PATH) == NpyError::NONE);
+    CHECK(array.type() == NpyType::FLOAT32);
+    CHECK(array.fortranOrder());
+    CHECK(anglesData(array) == nullptr);
+
+    Angles angles;
+    readAngles(array, 1, 1, &angles);
+    CHECK(angles == expected[1]);
+    std::vector<Angles> all;
+    REQUIRE(readNpy(PATH, all) == NpyError::NONE);
+    CHECK(all == expected);
+  }
+
+  SUBCASE("Errors") {
+    std::vector<Angles> angles;
+    CHECK(readNpy("does/not/exist.npy", angles) == NpyError::CANNOT_OPEN);
+
+    writeFile(1, "{'descr': '<i8', 'fortran_order': False, 'shape': (3, 3), }", expected.data(),
+              sizeof(Angles) * expected.size());
+    CHECK(readNpy(PATH, angles) == NpyError::UNSUPPORTED_TYPE);
+
+    writeFile(1, "{'descr': '<f8', 'fortran_order': False, 'shape': (9,), }", expected.data(),
+              sizeof(Angles) * expected.size());
+    CHECK(readNpy(PATH, angles) == NpyError::INVALID_SHAPE);
+
+    writeFile(1, "{'descr': '<f8', 'fortran_order': False, 'shape': (4, 3), }", expected.data(),
+              sizeof(Angles) * expected.size());
+    CHECK(readNpy(PATH, angles) == NpyError::TRUNCATED);
+
+    // Shapes whose sizes overflow must not pass the size check
+    writeFile(1, "{'descr': '<f8', 'fortran_order': False, 'shape': (6148914691236517206, 3), }",
+              expected.data(), 16);
+    CHECK(readNpy(PATH, angles) == NpyError::INVALID_HEADER);
+    writeFile(1, "{'descr': '<f8', 'fortran_order': False, 'shape': (768614336404564651, 3), }",
+              expected.data(), 16);
+    CHECK(readNpy(PATH, angles) == NpyError::TRUNCATED);
+    writeFile(1, "{'descr': '<f8', 'fortran_order': False, 'shape': (99999999999999999999, 3), }",
+              expected.data(), 16);
+    CHECK(readNpy(PATH, angles) == NpyError::INVALID_HEADER);
+
+    writeFile(1, "{'descr': '<f8', 'shape': (3, 3), }", expected.data(),
+              sizeof(Angles) * expected.size());
+    CHECK(readNpy(PATH, angles) == NpyError::INVALID_HEADER);
+
+    writeFile(7, "{'descr': '<f8', 'fortran_order': False, 'shape': (3, 3), }", expected.data(),
+              sizeof(Angles) * expected.size());
+    CHECK(readNpy(PATH, angles) == NpyError::INVALID_HEADER);
+  }
+
+  std::remove(PATH.c_str());
+}
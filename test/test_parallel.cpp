@@ -0,0 +1,113 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <euler/parallel.h>
+
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace euler;
+
+TEST_CASE("Parallel loops") {
+  for (const std::size_t threads : {1, 2, 3, 8}) {
+    ThreadPool pool(threads);
+    CHECK(pool.size() == threads);
+
+    // Every item is visited exactly once, in chunk-aligned calls, over many reuses of the pool
+    for (const std::size_t count : {0, 1, 7, 64, 1000, 4097}) {
+      for (const std::size_t chunk : {1, 5, 64, 5000}) {
+        std::vector<std::atomic<int>> visits(count);
+        for (auto& v : visits) {
+          v = 0;
+        }
+        std::atomic<bool> aligned(true);
+        pool.parallelFor(count, chunk, [&](std::size_t begin, std::size_t end) {
+          if (begin % chunk != 0 || end - begin > chunk || end > count || begin >= end) {
+            aligned = false;
+          }
+          for (std::size_t i = begin; i < end; ++i) {
+            ++visits[i];
+          }
+        });
+        CHECK(aligned);
+        for (std::size_t i = 0; i < count; ++i) {
+          REQUIRE(visits[i] == 1);
+        }
+      }
+    }
+  }
+
+  SUBCASE("Default size") {
+    ThreadPool pool;
+    CHECK(pool.size() >= 1);
+  }
+
+  SUBCASE("Uneven work is stolen") {
+    // The first share is much slower than the others; every chunk still runs exactly once
+    ThreadPool pool(4);
+    std::vector<std::atomic<int>> visits(64);
+    for (auto& v : visits) {
+      v = 0;
+    }
+    pool.parallelFor(visits.size(), 1, [&](std::size_t begin, std::size_t) {
+      if (begin < 16) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      }
+      ++visits[begin];
+    });
+    for (const auto& v : visits) {
+      REQUIRE(v == 1);
+    }
+  }
+}
+
+TEST_CASE("Parallel batch conversion") {
+  std::mt19937_64 generator(5);
+  std::uniform_real_distribution<double> distribution(-M_PI, M_PI);
+  std::vector<Angles> angles(3 * PARALLEL_CHUNK_SIZE + 17);
+  for (auto& a : angles) {
+    a = {distribution(generator), distribution(generator), distribution(generator)};
+  }
+  const std::size_t n = angles.size();
+  const Convention convention(Order::EXTRINSIC, Direction::ACTIVE);
+  ThreadPool pool(3);
+
+  std::vector<RotationMatrix> R(n), R_parallel(n);
+  toRotationMatrix("zxz", angles.data(), n, convention, R.data());
+  toRotationMatrix("zxz", angles.data(), n, convention, R_parallel.data(), pool);
+  CHECK(R == R_parallel);
+
+  std::vector<Quaternion> q(n), q_parallel(n);
+  toQuaternion("zxz", angles.data(), n, convention, q.data());
+  toQuaternion("zxz", angles.data(), n, convention, q_parallel.data(), pool);
+  CHECK(q == q_parallel);
+
+  std::vector<Angles> from_R(n), from_R_parallel(n), from_q(n), from_q_parallel(n);
+  toEulerAngles(R.data(), n, "zxz", convention, from_R.data());
+  toEulerAngles(R.data(), n, "zxz", convention, from_R_parallel.data(), pool);
+  CHECK(from_R == from_R_parallel);
+  toEulerAngles(q.data(), n, "zxz", convention, from_q.data());
+  toEulerAngles(q.data(), n, "zxz", convention, from_q_parallel.data(), pool);
+  CHECK(from_q == from_q_parallel);
+
+  std::vector<BinaryRecord> records(n);
+  toBinaryRecords("zxz", angles.data(), n, convention, records.data(), pool);
+  for (std::size_t i = 0; i < n; ++i) {
+    REQUIRE(records[i].R == R[i]);
+    REQUIRE(records[i].q == q[i]);
+  }
+
+  std::vector<ConventionCode> codes(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    codes[i] = ConventionCode::fromValue(i % CONVENTION_CODE_COUNT);
+  }
+  toRotationMatrix(codes.data(), angles.data(), n, R.data());
+  toRotationMatrix(codes.data(), angles.data(), n, R_parallel.data(), pool);
+  CHECK(R == R_parallel);
+  toQuaternion(codes.data(), angles.data(), n, q.data());
+  toQuaternion(codes.data(), angles.data(), n, q_parallel.data(), pool);
+  CHECK(q == q_parallel);
+}
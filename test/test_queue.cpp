@@ -0,0 +1,106 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <euler/queue.h>
+
+#include <chrono>
+#include <ctime>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace euler;
+
+TEST_CASE("Single-producer single-consumer queue") {
+  SUBCASE("Capacity") {
+    SpscQueue<int> queue(5);
+    CHECK(queue.capacity() == 8);
+    for (int i = 0; i < 8; ++i) {
+      int value = i;
+      REQUIRE(queue.tryPush(value));
+    }
+    int value = 8;
+    CHECK(!queue.tryPush(value));
+    for (int i = 0; i < 8; ++i) {
+      REQUIRE(queue.tryPop(value));
+      CHECK(value == i);
+    }
+    CHECK(!queue.tryPop(value));
+  }
+
+  SUBCASE("Closing") {
+    SpscQueue<std::unique_ptr<int>> queue(4);
+    REQUIRE(queue.push(std::unique_ptr<int>(new int(1))));
+    REQUIRE(queue.push(std::unique_ptr<int>(new int(2))));
+    queue.close();
+    CHECK(!queue.push(std::unique_ptr<int>(new int(3))));
+
+    // Items pushed before closing are still delivered
+    std::unique_ptr<int> value;
+    REQUIRE(queue.pop(value));
+    CHECK(*value == 1);
+    REQUIRE(queue.pop(value));
+    CHECK(*value == 2);
+    CHECK(!queue.pop(value));
+  }
+
+  SUBCASE("Threads") {
+    // Items arrive in order through a queue much smaller than the number of items
+    const std::size_t count = 200000;
+    SpscQueue<std::size_t> queue(16);
+    std::thread producer([&] {
+      for (std::size_t i = 0; i < count; ++i) {
+        queue.push(i);
+      }
+      queue.close();
+    });
+
+    std::vector<std::size_t> received;
+    std::size_t value;
+    while (queue.pop(value)) {
+      received.push_back(value);
+    }
+    producer.join();
+
+    REQUIRE(received.size() == count);
+    for (std::size_t i = 0; i < count; ++i) {
+      REQUIRE(received[i] == i);
+    }
+  }
+
+  SUBCASE("Consumer stops the producer") {
+    SpscQueue<int> queue(2);
+    bool stopped = false;
+    std::thread producer([&] {
+      int i = 0;
+      while (queue.push(i++)) {
+      }
+      stopped = true;
+    });
+    int value;
+    REQUIRE(queue.pop(value));
+    CHECK(value == 0);
+    queue.close();
+    producer.join();
+    CHECK(stopped);
+  }
+
+  SUBCASE("Waiting sleeps") {
+    // A consumer waiting on an empty queue uses hardly any processor time, and still wakes up
+    SpscQueue<int> queue(2);
+    double cpu_seconds = 0;
+    int value = 0;
+    bool popped = false;
+    std::thread consumer([&] {
+      const std::clock_t start = std::clock();
+      popped = queue.pop(value);
+      cpu_seconds = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    queue.push(42);
+    consumer.join();
+    CHECK(popped);
+    CHECK(value == 42);
+    CHECK(cpu_seconds < 0.1);
+  }
+}
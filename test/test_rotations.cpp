@@ -6,6 +6,8 @@
 
 #include <cmath>
 #include <iostream>
+#include <string>
+#include <vector>
 
 using namespace euler;
 
@@ -31,6 +33,56 @@ Vector operator*(const RotationMatrix& R, const Vector& v) {
   // clang-format on
 }
 
+TEST_CASE("Sequences") {
+  // Names of literals are parsed at compile time
+  static_assert(Sequence("zyx").id() == SequenceId::ZYX, "zyx");
+  static_assert(Sequence("zxz").proper() && !Sequence("zyx").proper(), "proper sequences");
+  static_assert(Sequence("xyz").reversed() == Sequence("zyx"), "reversed sequences");
+  static_assert(Sequence("yxy").axis(1) == Axis::X, "axes");
+  static_assert(Sequence::fromAxes(Axis::Y, Axis::X, Axis::Y) == SequenceId::YXY, "axes");
+  static_assert(!Sequence("").valid() && !Sequence("zy").valid() && !Sequence("zyxz").valid(),
+                "names of the wrong length");
+
+  SUBCASE("Every name of three axes") {
+    const std::string axes = "xyz";
+    int valid = 0;
+    for (int a = 0; a < 3; ++a) {
+      for (int b = 0; b < 3; ++b) {
+        for (int c = 0; c < 3; ++c) {
+          const std::string name = {axes[a], axes[b], axes[c]};
+          const Sequence sequence = name;
+          CHECK(Sequence(name.c_str()) == sequence);
+          CHECK(sequence.valid() == (a != b && b != c));
+          if (!sequence.valid()) {
+            CHECK(std::string(sequence.name()).empty());
+            continue;
+          }
+          ++valid;
+          CHECK(sequence.name() == name);
+          CHECK(sequence.axis(0) == static_cast<Axis>(a));
+          CHECK(sequence.axis(1) == static_cast<Axis>(b));
+          CHECK(sequence.axis(2) == static_cast<Axis>(c));
+          CHECK(sequence.proper() == (a == c));
+          CHECK(sequence.reversed().name() == std::string({axes[c], axes[b], axes[a]}));
+          CHECK(Sequence::fromAxes(static_cast<Axis>(a), static_cast<Axis>(b),
+                                   static_cast<Axis>(c)) == sequence);
+        }
+      }
+    }
+    CHECK(valid == 12);
+  }
+
+  SUBCASE("Invalid names") {
+    const char* null = nullptr;
+    CHECK_FALSE(Sequence(null).valid());
+    CHECK_FALSE(Sequence("ZYX").valid());
+    CHECK_FALSE(Sequence(std::string("zyx\0", 4)).valid());
+    CHECK_FALSE(Sequence(static_cast<SequenceId>(200)).valid());
+    CHECK(std::string(Sequence(static_cast<SequenceId>(200)).name()).empty());
+    CHECK(Sequence() == SequenceId::INVALID);
+  }
+}
+
 TEST_CASE("Identity") {
   RotationMatrix R_expect = {1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0};
   RotationMatrix R_actual =
@@ -447,3 +499,231 @@ TEST_CASE("Quaternions") {
   q_actual = toQuaternion(R);
   CHECK(approxEq(q_actual, q_expect));
 }
+
+RotationMatrix elementalRotation(char axis, double angle) {
+  const auto c = std::cos(angle);
+  const auto s = std::sin(angle);
+  if (axis == 'x') {
+    return {1.0, 0.0, 0.0, 0.0, c, -s, 0.0, s, c};
+  } else if (axis == 'y') {
+    return {c, 0.0, s, 0.0, 1.0, 0.0, -s, 0.0, c};
+  }
+  return {c, -s, 0.0, s, c, 0.0, 0.0, 0.0, 1.0};
+}
+
+TEST_CASE("Closed-form rotations match products of elemental rotations") {
+  const std::array<std::string, 12> sequences = {"xyz", "xzy", "yxz", "yzx", "zxy", "zyx",
+                                                 "xyx", "xzx", "yxy", "yzy", "zxz", "zyz"};
+  const Angles angles = {0.3, -1.2, 2.7};
+
+  for (const auto& seq : sequences) {
+    const RotationMatrix R_1 = elementalRotation(seq[0], angles[0]);
+    const RotationMatrix R_2 = elementalRotation(seq[1], angles[1]);
+    const RotationMatrix R_3 = elementalRotation(seq[2], angles[2]);
+    const RotationMatrix R_intrinsic = R_1 * R_2 * R_3;
+    const RotationMatrix R_extrinsic = R_3 * R_2 * R_1;
+
+    CHECK(approxEq(toRotationMatrix(seq, angles, {Order::INTRINSIC, Direction::ACTIVE}),
+                   R_intrinsic));
+    CHECK(approxEq(toRotationMatrix(seq, angles, {Order::INTRINSIC, Direction::PASSIVE}),
+                   transpose(R_intrinsic)));
+    CHECK(approxEq(toRotationMatrix(seq, angles, {Order::EXTRINSIC, Direction::ACTIVE}),
+                   R_extrinsic));
+    CHECK(approxEq(toRotationMatrix(seq, angles, {Order::EXTRINSIC, Direction::PASSIVE}),
+                   transpose(R_extrinsic)));
+  }
+}
+
+TEST_CASE("Batch conversion") {
+  // The batch conversion must agree with the single conversion for every sequence and convention
+  const std::array<std::string, 12> sequences = {"xyz", "xzy", "yxz", "yzx", "zxy", "zyx",
+                                                 "xyx", "xzx", "yxy", "yzy", "zxz", "zyz"};
+  const std::array<Convention, 4> conventions = {{{Order::INTRINSIC, Direction::ACTIVE},
+                                                  {Order::INTRINSIC, Direction::PASSIVE},
+                                                  {Order::EXTRINSIC, Direction::ACTIVE},
+                                                  {Order::EXTRINSIC, Direction::PASSIVE}}};
+
+  // Enough sets of angles to span several blocks of the batch conversion
+  std::vector<Angles> angles;
+  for (int i = 0; i < 300; ++i) {
+    angles.push_back({0.013 * i - 3.1, -0.007 * i + 1.4, 0.029 * i - 7.0});
+  }
+
+  for (const auto& sequence : sequences) {
+    for (const auto& convention : conventions) {
+      std::vector<RotationMatrix> R_actual(angles.size());
+      toRotationMatrix(sequence, angles.data(), angles.size(), convention, R_actual.data());
+      for (std::size_t i = 0; i < angles.size(); ++i) {
+        CHECK(approxEq(R_actual[i], toRotationMatrix(sequence, angles[i], convention)));
+      }
+    }
+  }
+
+  SUBCASE("Empty batch") {
+    toRotationMatrix("zyx", angles.data(), 0, {Order::INTRINSIC, Direction::ACTIVE}, nullptr);
+  }
+}
+
+TEST_CASE("Convention codes") {
+  static_assert(ConventionCode("xyz", {Order::INTRINSIC, Direction::ACTIVE}).value() == 0, "xyz");
+  static_assert(ConventionCode("zyz", {Order::EXTRINSIC, Direction::PASSIVE}).value() == 47, "zyz");
+  static_assert(!ConventionCode("xxy", {Order::INTRINSIC, Direction::ACTIVE}).valid(), "invalid");
+  static_assert(!ConventionCode().valid() && !ConventionCode::fromValue(48).valid(), "invalid");
+
+  SUBCASE("Every code") {
+    for (std::uint8_t value = 0; value < CONVENTION_CODE_COUNT; ++value) {
+      const ConventionCode code = ConventionCode::fromValue(value);
+      REQUIRE(code.valid());
+      const Convention convention = code.convention();
+      CHECK(ConventionCode(code.sequence(), convention) == code);
+    }
+    CHECK_FALSE(ConventionCode::fromValue(255).sequence().valid());
+  }
+
+  SUBCASE("Batches of mixed conventions") {
+    // Each record must be converted as a batch of its own code alone would convert it
+    std::vector<Angles> angles;
+    std::vector<ConventionCode> codes;
+    for (int i = 0; i < 300; ++i) {
+      angles.push_back({0.013 * i - 3.1, -0.007 * i + 1.4, 0.029 * i - 7.0});
+      codes.push_back(ConventionCode::fromValue((7 * i) % CONVENTION_CODE_COUNT));
+    }
+
+    std::vector<RotationMatrix> R(angles.size());
+    std::vector<Quaternion> q(angles.size());
+    toRotationMatrix(codes.data(), angles.data(), angles.size(), R.data());
+    toQuaternion(codes.data(), angles.data(), angles.size(), q.data());
+    for (std::size_t i = 0; i < angles.size(); ++i) {
+      RotationMatrix R_expect;
+      Quaternion q_expect;
+      toRotationMatrix(codes[i].sequence(), &angles[i], 1, codes[i].convention(), &R_expect);
+      toQuaternion(codes[i].sequence(), &angles[i], 1, codes[i].convention(), &q_expect);
+      REQUIRE(R[i] == R_expect);
+      REQUIRE(q[i] == q_expect);
+    }
+  }
+}
+
+template <Axis A1, Axis A2, Axis A3, Order ORDER, Direction DIRECTION>
+void checkCompileTime(Sequence sequence, const Angles& angles) {
+  const RotationMatrix R_expect = toRotationMatrix(sequence, angles, {ORDER, DIRECTION});
+  const RotationMatrix R_actual = toRotationMatrix<A1, A2, A3, ORDER, DIRECTION>(angles);
+  CHECK(approxEq(R_actual, R_expect));
+}
+
+template <Axis A1, Axis A2, Axis A3>
+void checkCompileTime(Sequence sequence, const Angles& angles) {
+  checkCompileTime<A1, A2, A3, Order::INTRINSIC, Direction::ACTIVE>(sequence, angles);
+  checkCompileTime<A1, A2, A3, Order::INTRINSIC, Direction::PASSIVE>(sequence, angles);
+  checkCompileTime<A1, A2, A3, Order::EXTRINSIC, Direction::ACTIVE>(sequence, angles);
+  checkCompileTime<A1, A2, A3, Order::EXTRINSIC, Direction::PASSIVE>(sequence, angles);
+}
+
+TEST_CASE("Compile-time sequence and convention") {
+  const Angles angles = {-0.4, 0.9, 2.2};
+  checkCompileTime<Axis::X, Axis::Y, Axis::Z>("xyz", angles);
+  checkCompileTime<Axis::X, Axis::Z, Axis::Y>("xzy", angles);
+  checkCompileTime<Axis::Y, Axis::X, Axis::Z>("yxz", angles);
+  checkCompileTime<Axis::Y, Axis::Z, Axis::X>("yzx", angles);
+  checkCompileTime<Axis::Z, Axis::X, Axis::Y>("zxy", angles);
+  checkCompileTime<Axis::Z, Axis::Y, Axis::X>("zyx", angles);
+  checkCompileTime<Axis::X, Axis::Y, Axis::X>("xyx", angles);
+  checkCompileTime<Axis::X, Axis::Z, Axis::X>("xzx", angles);
+  checkCompileTime<Axis::Y, Axis::X, Axis::Y>("yxy", angles);
+  checkCompileTime<Axis::Y, Axis::Z, Axis::Y>("yzy", angles);
+  checkCompileTime<Axis::Z, Axis::X, Axis::Z>("zxz", angles);
+  checkCompileTime<Axis::Z, Axis::Y, Axis::Z>("zyz", angles);
+}
+
+TEST_CASE("Direct quaternions") {
+  // The direct conversion must describe the same rotation as converting via a rotation matrix
+  const std::array<std::string, 12> sequences = {"xyz", "xzy", "yxz", "yzx", "zxy", "zyx",
+                                                 "xyx", "xzx", "yxy", "yzy", "zxz", "zyz"};
+  const std::array<Convention, 4> conventions = {{{Order::INTRINSIC, Direction::ACTIVE},
+                                                  {Order::INTRINSIC, Direction::PASSIVE},
+                                                  {Order::EXTRINSIC, Direction::ACTIVE},
+                                                  {Order::EXTRINSIC, Direction::PASSIVE}}};
+
+  std::vector<Angles> angles;
+  for (int i = 0; i < 300; ++i) {
+    angles.push_back({0.017 * i - 3.3, -0.008 * i + 1.5, 0.031 * i - 6.1});
+  }
+
+  for (const auto& sequence : sequences) {
+    for (const auto& convention : conventions) {
+      std::vector<Quaternion> q_batch(angles.size());
+      toQuaternion(sequence, angles.data(), angles.size(), convention, q_batch.data());
+
+      for (std::size_t i = 0; i < angles.size(); ++i) {
+        const Quaternion q_actual = toQuaternion(sequence, angles[i], convention);
+        const Quaternion q_expect = toQuaternion(toRotationMatrix(sequence, angles[i], convention));
+        const Quaternion q_negated = {-q_expect[0], -q_expect[1], -q_expect[2], -q_expect[3]};
+        CHECK(q_actual[0] >= 0.0);
+        CHECK((approxEq(q_actual, q_expect) || approxEq(q_actual, q_negated)));
+        CHECK(approxEq(q_batch[i], q_actual));
+      }
+    }
+  }
+}
+
+TEST_CASE("Euler angles from rotation matrices and quaternions") {
+  const std::array<std::string, 12> sequences = {"xyz", "xzy", "yxz", "yzx", "zxy", "zyx",
+                                                 "xyx", "xzx", "yxy", "yzy", "zxz", "zyz"};
+  const std::array<Convention, 4> conventions = {{{Order::INTRINSIC, Direction::ACTIVE},
+                                                  {Order::INTRINSIC, Direction::PASSIVE},
+                                                  {Order::EXTRINSIC, Direction::ACTIVE},
+                                                  {Order::EXTRINSIC, Direction::PASSIVE}}};
+
+  SUBCASE("Round trip") {
+    // Angles inside the documented ranges and away from gimbal lock are recovered exactly
+    for (const auto& sequence : sequences) {
+      const bool proper = sequence[0] == sequence[2];
+      std::vector<Angles> angles;
+      for (int i = 0; i < 100; ++i) {
+        const double middle = proper ? 0.03 * i + 0.01 : 0.03 * i - 1.5;
+        angles.push_back({0.0627 * i - 3.1, middle, -0.0611 * i + 3.0});
+      }
+
+      for (const auto& convention : conventions) {
+        std::vector<RotationMatrix> R(angles.size());
+        std::vector<Quaternion> q(angles.size());
+        std::vector<Angles> from_R(angles.size());
+        std::vector<Angles> from_q(angles.size());
+        toRotationMatrix(sequence, angles.data(), angles.size(), convention, R.data());
+        toQuaternion(sequence, angles.data(), angles.size(), convention, q.data());
+        toEulerAngles(R.data(), R.size(), sequence, convention, from_R.data());
+        toEulerAngles(q.data(), q.size(), sequence, convention, from_q.data());
+
+        for (std::size_t i = 0; i < angles.size(); ++i) {
+          CHECK(approxEq(from_R[i], angles[i]));
+          CHECK(approxEq(from_q[i], angles[i]));
+          CHECK(approxEq(toEulerAngles(R[i], sequence, convention), from_R[i]));
+          CHECK(approxEq(toEulerAngles(q[i], sequence, convention), from_q[i]));
+        }
+      }
+    }
+  }
+
+  SUBCASE("Gimbal lock") {
+    // The recovered angles describe the same rotation, with the third angle zero
+    for (const auto& sequence : sequences) {
+      const bool proper = sequence[0] == sequence[2];
+      const std::array<double, 2> singular = {proper ? 0.0 : -M_PI_2, proper ? M_PI : M_PI_2};
+
+      for (const auto& convention : conventions) {
+        for (const auto middle : singular) {
+          const Angles angles = {0.7, middle, -0.4};
+          const RotationMatrix R = toRotationMatrix(sequence, angles, convention);
+          const Quaternion q = toQuaternion(sequence, angles, convention);
+
+          const Angles from_R = toEulerAngles(R, sequence, convention);
+          const Angles from_q = toEulerAngles(q, sequence, convention);
+          CHECK(from_R[2] == 0.0);
+          CHECK(from_q[2] == 0.0);
+          CHECK(approxEq(toRotationMatrix(sequence, from_R, convention), R));
+          CHECK(approxEq(toRotationMatrix(sequence, from_q, convention), R));
+        }
+      }
+    }
+  }
+}
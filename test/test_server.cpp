@@ -0,0 +1,215 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <euler/server.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace euler;
+using protocol::Status;
+
+namespace {
+
+/// Runs a server on another thread until destroyed
+class ServerThread {
+ public:
+  explicit ServerThread(Server& server) : server_(server), thread_([&server] { server.run(); }) {}
+  ~ServerThread() {
+    server_.stop();
+    thread_.join();
+  }
+
+ private:
+  Server& server_;
+  std::thread thread_;
+};
+
+}  // namespace
+
+TEST_CASE("Conversion server") {
+  const std::string path = "test_server.sock";
+  ThreadPool pool(2);
+  Server server(pool);
+  REQUIRE(server.listen(path));
+  ServerThread thread(server);
+
+  std::mt19937_64 generator(3);
+  std::uniform_real_distribution<double> distribution(-M_PI, M_PI);
+  std::vector<Angles> angles(5000);
+  for (auto& a : angles) {
+    a = {distribution(generator), distribution(generator), distribution(generator)};
+  }
+  const Convention convention(Order::EXTRINSIC, Direction::PASSIVE);
+  std::vector<RotationMatrix> R_expected(angles.size());
+  std::vector<Quaternion> q_expected(angles.size());
+  toRotationMatrix("yzy", angles.data(), angles.size(), convention, R_expected.data());
+  toQuaternion("yzy", angles.data(), angles.size(), convention, q_expected.data());
+
+  SUBCASE("Round trips") {
+    Client client;
+    REQUIRE(client.connect(path));
+    for (const std::size_t count : {std::size_t(1), std::size_t(0), angles.size()}) {
+      // Null pointers mean that an output is not wanted, so the buffers are never empty
+      std::vector<RotationMatrix> R(std::max<std::size_t>(count, 1));
+      std::vector<Quaternion> q(std::max<std::size_t>(count, 1));
+      REQUIRE(client.convert("yzy", angles.data(), count, convention, R.data(), q.data()) ==
+              Status::OK);
+      CHECK(std::equal(R.begin(), R.begin() + count, R_expected.begin()));
+      CHECK(std::equal(q.begin(), q.begin() + count, q_expected.begin()));
+
+      std::fill(R.begin(), R.end(), RotationMatrix());
+      REQUIRE(client.convert("yzy", angles.data(), count, convention, R.data(), nullptr) ==
+              Status::OK);
+      CHECK(std::equal(R.begin(), R.begin() + count, R_expected.begin()));
+
+      std::fill(q.begin(), q.end(), Quaternion());
+      REQUIRE(client.convert("yzy", angles.data(), count, convention, nullptr, q.data()) ==
+              Status::OK);
+      CHECK(std::equal(q.begin(), q.begin() + count, q_expected.begin()));
+    }
+  }
+
+  SUBCASE("Invalid requests") {
+    Client client;
+    REQUIRE(client.connect(path));
+    Quaternion q;
+    CHECK(client.convert("xxy", angles.data(), 1, convention, nullptr, &q) ==
+          Status::INVALID_SEQUENCE);
+    CHECK(client.convert("yzy", angles.data(), 1, convention, nullptr, nullptr) ==
+          Status::INVALID_OUTPUTS);
+
+    // Too many angles are rejected before anything is sent
+    CHECK(client.convert("yzy", angles.data(), std::size_t(protocol::MAX_COUNT) + 1, convention,
+                         nullptr, &q) == Status::TOO_LARGE);
+    CHECK(client.convert("yzy", angles.data(), std::size_t(1) << 32, convention, nullptr, &q) ==
+          Status::TOO_LARGE);
+
+    // The connection is still usable after a rejected request
+    REQUIRE(client.convert("yzy", angles.data(), 1, convention, nullptr, &q) == Status::OK);
+    CHECK(q == q_expected[0]);
+  }
+
+  SUBCASE("Pipelined requests in degrees") {
+    // Several requests are sent before any response is read
+    const int socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    std::strcpy(addr.sun_path, path.c_str());
+    REQUIRE(::connect(socket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+
+    protocol::RequestHeader request;
+    std::memcpy(request.sequence, "zyx", 3);
+    request.order = 0;
+    request.direction = 0;
+    request.outputs = protocol::OUTPUT_QUATERNION;
+    request.flags = protocol::FLAG_DEGREES;
+    request.count = 1;
+    const Angles degrees = {20, -10, 35};
+    std::vector<char> requests;
+    for (int i = 0; i < 3; ++i) {
+      requests.insert(requests.end(), reinterpret_cast<const char*>(&request),
+                      reinterpret_cast<const char*>(&request + 1));
+      requests.insert(requests.end(), reinterpret_cast<const char*>(&degrees),
+                      reinterpret_cast<const char*>(&degrees + 1));
+    }
+    REQUIRE(::write(socket, requests.data(), requests.size()) == ssize_t(requests.size()));
+    ::shutdown(socket, SHUT_WR);
+
+    Angles radians = degrees;
+    for (auto& x : radians) {
+      x *= M_PI / 180;
+    }
+    const Quaternion expected =
+        toQuaternion("zyx", radians, Convention(Order::INTRINSIC, Direction::ACTIVE));
+    std::vector<char> responses;
+    char buffer[256];
+    ssize_t n;
+    while ((n = ::read(socket, buffer, sizeof(buffer))) > 0) {
+      responses.insert(responses.end(), buffer, buffer + n);
+    }
+    ::close(socket);
+
+    const std::size_t size = sizeof(protocol::ResponseHeader) + sizeof(Quaternion);
+    REQUIRE(responses.size() == 3 * size);
+    for (int i = 0; i < 3; ++i) {
+      protocol::ResponseHeader response;
+      std::memcpy(&response, responses.data() + i * size, sizeof(response));
+      CHECK(response.status == Status::OK);
+      CHECK(response.count == 1);
+      Quaternion q;
+      std::memcpy(&q, responses.data() + i * size + sizeof(response), sizeof(q));
+      CHECK(q == expected);
+    }
+  }
+
+  SUBCASE("Invalid header closes the connection") {
+    const int socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    std::strcpy(addr.sun_path, path.c_str());
+    REQUIRE(::connect(socket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    const char garbage[16] = "not a request";
+    REQUIRE(::write(socket, garbage, sizeof(garbage)) == sizeof(garbage));
+
+    protocol::ResponseHeader response;
+    REQUIRE(::read(socket, &response, sizeof(response)) == sizeof(response));
+    CHECK(response.status == Status::INVALID_HEADER);
+    char byte;
+    CHECK(::read(socket, &byte, 1) == 0);
+    ::close(socket);
+  }
+}
+
+TEST_CASE("Client without a server") {
+  Client client;
+  CHECK(!client.connect("does/not/exist.sock"));
+  Quaternion q;
+  const Angles angles = {0, 0, 0};
+  CHECK(client.convert("zyx", &angles, 1, Convention(Order::INTRINSIC, Direction::ACTIVE),
+                       nullptr, &q) == Status::INVALID_HEADER);
+}
+
+TEST_CASE("Socket paths") {
+  const std::string path = "test_server_path.sock";
+  ThreadPool pool(1);
+
+  SUBCASE("Regular files are never replaced") {
+    std::ofstream(path) << "notes";
+    Server server(pool);
+    CHECK_FALSE(server.listen(path));
+    std::string contents;
+    std::ifstream(path) >> contents;
+    CHECK(contents == "notes");
+    std::remove(path.c_str());
+  }
+
+  SUBCASE("Live sockets are not taken over, stale ones are") {
+    {
+      Server first(pool);
+      REQUIRE(first.listen(path));
+      Server second(pool);
+      CHECK_FALSE(second.listen(path));
+    }
+
+    // A socket file left behind by a server that no longer runs
+    const int socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::strcpy(addr.sun_path, path.c_str());
+    REQUIRE(::bind(socket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    ::close(socket);
+
+    Server server(pool);
+    CHECK(server.listen(path));
+  }
+}
@@ -0,0 +1,198 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <euler/shm.h>
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace euler;
+
+namespace {
+
+/// Runs the worker of a ring on another thread until destroyed
+class WorkerThread {
+ public:
+  explicit WorkerThread(SharedRing& ring) : ring_(ring), thread_([&ring] { ring.run(); }) {}
+  ~WorkerThread() {
+    ring_.stop();
+    thread_.join();
+  }
+
+ private:
+  SharedRing& ring_;
+  std::thread thread_;
+};
+
+std::vector<Angles> randomAngles(std::size_t count) {
+  std::mt19937_64 generator(5);
+  std::uniform_real_distribution<double> distribution(-M_PI, M_PI);
+  std::vector<Angles> angles(count);
+  for (auto& a : angles) {
+    a = {distribution(generator), distribution(generator), distribution(generator)};
+  }
+  return angles;
+}
+
+/// The worker uses the batch kernels, whose results for one set of angles do not depend on the rest
+RotationMatrix matrix(Sequence sequence, const Angles& angles, Convention convention) {
+  RotationMatrix R;
+  toRotationMatrix(sequence, &angles, 1, convention, &R);
+  return R;
+}
+
+Quaternion quaternion(Sequence sequence, const Angles& angles, Convention convention) {
+  Quaternion q;
+  toQuaternion(sequence, &angles, 1, convention, &q);
+  return q;
+}
+
+}  // namespace
+
+TEST_CASE("Shared-memory ring") {
+  const std::string path = "test_shm.ring";
+  SharedRing worker;
+  REQUIRE(worker.create(path, 5));
+  CHECK(worker.capacity() == 8);
+
+  SharedRing producer;
+  REQUIRE(producer.open(path));
+  CHECK(producer.capacity() == 8);
+
+  const auto angles = randomAngles(100);
+  const Convention intrinsic(Order::INTRINSIC, Direction::ACTIVE);
+  const Convention extrinsic(Order::EXTRINSIC, Direction::PASSIVE);
+
+  SUBCASE("Requests are converted in batches") {
+    // Fill the ring with runs of two conventions, which the worker converts in one call
+    std::vector<std::uint64_t> tickets;
+    std::uint64_t ticket;
+    for (std::size_t i = 0; i < producer.capacity(); ++i) {
+      REQUIRE(producer.trySubmit("zyx", angles[i], i < 3 ? intrinsic : extrinsic, ticket));
+      tickets.push_back(ticket);
+    }
+    CHECK_FALSE(producer.trySubmit("zyx", angles[0], intrinsic, ticket));
+
+    RotationMatrix R;
+    Quaternion q;
+    CHECK(producer.tryCollect(tickets[0], R, q) == SharedStatus::PENDING);
+    CHECK(worker.process() == producer.capacity());
+    CHECK(worker.process() == 0);
+    for (std::size_t i = 0; i < tickets.size(); ++i) {
+      const Convention convention = i < 3 ? intrinsic : extrinsic;
+      REQUIRE(producer.tryCollect(tickets[i], R, q) == SharedStatus::OK);
+      CHECK(R == matrix("zyx", angles[i], convention));
+      CHECK(q == quaternion("zyx", angles[i], convention));
+    }
+
+    // Collected slots are free again
+    CHECK(producer.trySubmit("zyx", angles[0], intrinsic, ticket));
+    CHECK(ticket == producer.capacity());
+    CHECK(worker.process() == 1);
+    CHECK(producer.collect(ticket, R, q) == SharedStatus::OK);
+  }
+
+  SUBCASE("Invalid conventions") {
+    const std::uint64_t invalid = producer.submit("xxy", angles[0], intrinsic);
+    const std::uint64_t valid = producer.submit("zxz", angles[1], intrinsic);
+    CHECK(worker.process() == 2);
+
+    RotationMatrix R = {};
+    Quaternion q = {};
+    CHECK(producer.collect(invalid, R, q) == SharedStatus::INVALID_CONVENTION);
+    CHECK(R == RotationMatrix());
+    CHECK(producer.collect(valid, R, q) == SharedStatus::OK);
+    CHECK(R == matrix("zxz", angles[1], intrinsic));
+  }
+
+  SUBCASE("Several producer threads") {
+    WorkerThread thread(worker);
+    std::vector<std::thread> producers;
+    std::vector<int> failures(4, 0);
+    for (int p = 0; p < 4; ++p) {
+      producers.emplace_back([&, p] {
+        const Sequence sequences[] = {"xyz", "yxy", "zxz", "zyx"};
+        for (int round = 0; round < 50; ++round) {
+          for (const auto& a : angles) {
+            RotationMatrix R;
+            Quaternion q;
+            if (producer.convert(sequences[p], a, extrinsic, R, q) != SharedStatus::OK ||
+                R != matrix(sequences[p], a, extrinsic) ||
+                q != quaternion(sequences[p], a, extrinsic)) {
+              ++failures[p];
+            }
+          }
+        }
+      });
+    }
+    for (auto& t : producers) {
+      t.join();
+    }
+    CHECK(failures == std::vector<int>(4, 0));
+  }
+
+  SUBCASE("Another process") {
+    WorkerThread thread(worker);
+    const pid_t child = ::fork();
+    REQUIRE(child != -1);
+    if (child == 0) {
+      SharedRing ring;
+      int failures = ring.open(path) ? 0 : 1;
+      for (const auto& a : angles) {
+        RotationMatrix R;
+        Quaternion q;
+        if (ring.convert("yzx", a, intrinsic, R, q) != SharedStatus::OK ||
+            R != matrix("yzx", a, intrinsic)) {
+          ++failures;
+        }
+      }
+      ::_exit(failures == 0 ? 0 : 1);
+    }
+    int status;
+    REQUIRE(::waitpid(child, &status, 0) == child);
+    CHECK(WIFEXITED(status));
+    CHECK(WEXITSTATUS(status) == 0);
+  }
+
+  SUBCASE("Only rings can be opened") {
+    SharedRing ring;
+    CHECK_FALSE(ring.open("test_shm.missing"));
+    std::FILE* file = std::fopen("test_shm.other", "wb");
+    REQUIRE(file != nullptr);
+    std::fputs("not a ring", file);
+    std::fclose(file);
+    CHECK_FALSE(ring.open("test_shm.other"));
+    CHECK_FALSE(ring.isOpen());
+    CHECK(ring.capacity() == 0);
+    std::remove("test_shm.other");
+  }
+
+  SUBCASE("Only rings are replaced") {
+    std::FILE* file = std::fopen("test_shm.other", "wb");
+    REQUIRE(file != nullptr);
+    std::fputs("not a ring", file);
+    std::fclose(file);
+    SharedRing ring;
+    CHECK_FALSE(ring.create("test_shm.other", 4));
+    char contents[16] = {};
+    file = std::fopen("test_shm.other", "rb");
+    REQUIRE(file != nullptr);
+    CHECK(std::fgets(contents, sizeof(contents), file) != nullptr);
+    std::fclose(file);
+    CHECK(std::string(contents) == "not a ring");
+    std::remove("test_shm.other");
+
+    // A ring left behind by another worker is replaced
+    REQUIRE(ring.create(path, 4));
+    CHECK(ring.capacity() == 4);
+  }
+
+  producer.close();
+  worker.close();
+  std::remove(path.c_str());
+}
@@ -0,0 +1,131 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <euler/sincos.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace euler;
+
+/// Distance between two doubles in units in the last place
+std::int64_t ulpDistance(double a, double b) {
+  const auto ordered = [](double x) {
+    std::int64_t i;
+    std::memcpy(&i, &x, sizeof(i));
+    return i < 0 ? std::numeric_limits<std::int64_t>::min() - i : i;
+  };
+  const auto d = ordered(a) - ordered(b);
+  return d < 0 ? -d : d;
+}
+
+/// Every instruction set this build can run on this CPU
+std::vector<SimdLevel> supportedLevels() {
+  std::vector<SimdLevel> levels;
+  for (const auto level :
+       {SimdLevel::SCALAR, SimdLevel::BASELINE, SimdLevel::AVX2, SimdLevel::AVX512}) {
+    if (level <= supportedSimdLevel()) {
+      levels.push_back(level);
+    }
+  }
+  return levels;
+}
+
+/// Largest ULP error of sincos relative to std::sin and std::cos over the given angles, across
+/// every supported instruction set
+std::int64_t maxUlpError(const std::vector<double>& angles) {
+  std::vector<double> s(angles.size());
+  std::vector<double> c(angles.size());
+
+  std::int64_t max_error = 0;
+  for (const auto level : supportedLevels()) {
+    sincos(angles.data(), angles.size(), s.data(), c.data(), level);
+    for (std::size_t i = 0; i < angles.size(); ++i) {
+      max_error = std::max(max_error, ulpDistance(s[i], std::sin(angles[i])));
+      max_error = std::max(max_error, ulpDistance(c[i], std::cos(angles[i])));
+    }
+  }
+  return max_error;
+}
+
+std::vector<double> uniformAngles(double limit, std::size_t count) {
+  std::mt19937_64 generator(42);
+  std::uniform_real_distribution<double> distribution(-limit, limit);
+  std::vector<double> angles(count);
+  for (auto& a : angles) {
+    a = distribution(generator);
+  }
+  return angles;
+}
+
+TEST_CASE("Accuracy of sincos") {
+  SUBCASE("Typical Euler angles") {
+    CHECK(maxUlpError(uniformAngles(2 * M_PI, 50000)) <= SINCOS_MAX_ULP_ERROR);
+  }
+
+  SUBCASE("Angles in degrees mistaken for radians") {
+    CHECK(maxUlpError(uniformAngles(360.0, 50000)) <= SINCOS_MAX_ULP_ERROR);
+  }
+
+  SUBCASE("Full reduced range") {
+    CHECK(maxUlpError(uniformAngles(SINCOS_MAX_REDUCED_ANGLE, 50000)) <= SINCOS_MAX_ULP_ERROR);
+  }
+
+  SUBCASE("Small angles") {
+    CHECK(maxUlpError(uniformAngles(1e-6, 10000)) <= SINCOS_MAX_ULP_ERROR);
+  }
+
+  SUBCASE("Closest doubles to multiples of pi/2") {
+    // These stress the argument reduction, where the result cancels to a tiny remainder
+    std::vector<double> angles;
+    for (int n = -20000; n <= 20000; ++n) {
+      double a = n * M_PI_2;
+      for (int j = 0; j < 3; ++j) {
+        angles.push_back(a);
+        a = std::nextafter(a, std::numeric_limits<double>::infinity());
+      }
+    }
+    CHECK(maxUlpError(angles) <= SINCOS_MAX_ULP_ERROR);
+  }
+}
+
+TEST_CASE("Special angles in sincos") {
+  const double inf = std::numeric_limits<double>::infinity();
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  std::vector<double> angles = {0.0, M_PI, -M_PI_2, 1e7, -3.5e12, 1e300, inf, -inf, nan};
+  std::vector<double> s(angles.size());
+  std::vector<double> c(angles.size());
+
+  for (const auto level : supportedLevels()) {
+    sincos(angles.data(), angles.size(), s.data(), c.data(), level);
+    CHECK(s[0] == 0.0);
+    CHECK(c[0] == 1.0);
+    for (std::size_t i = 1; i < 6; ++i) {
+      CHECK(ulpDistance(s[i], std::sin(angles[i])) <= SINCOS_MAX_ULP_ERROR);
+      CHECK(ulpDistance(c[i], std::cos(angles[i])) <= SINCOS_MAX_ULP_ERROR);
+    }
+    for (std::size_t i = 6; i < angles.size(); ++i) {
+      CHECK(std::isnan(s[i]));
+      CHECK(std::isnan(c[i]));
+    }
+  }
+}
+
+TEST_CASE("Runtime selection of the instruction set") {
+  CHECK(simdLevel() <= supportedSimdLevel());
+#if defined(__GNUC__)
+  CHECK(supportedSimdLevel() >= SimdLevel::BASELINE);
+#endif
+}
+
+TEST_CASE("Batch sizes in sincos") {
+  // Every remainder length must be handled
+  for (std::size_t count = 0; count < 20; ++count) {
+    const auto angles = uniformAngles(10.0, count);
+    CHECK(maxUlpError(angles) <= SINCOS_MAX_ULP_ERROR);
+  }
+}
@@ -0,0 +1,77 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <euler/parallel.h>
+#include <euler/trace.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace euler;
+
+namespace {
+
+std::string readFile(const std::string& path) {
+  std::ifstream file(path);
+  std::ostringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+std::size_t occurrences(const std::string& text, const std::string& pattern) {
+  std::size_t count = 0;
+  for (auto i = text.find(pattern); i != std::string::npos; i = text.find(pattern, i + 1)) {
+    ++count;
+  }
+  return count;
+}
+
+}  // namespace
+
+TEST_CASE("Traces") {
+  const std::string path = "test_trace.json";
+  const std::vector<Angles> angles(3 * PARALLEL_CHUNK_SIZE, Angles{0.1, -0.2, 0.3});
+  std::vector<RotationMatrix> R(angles.size());
+  const Convention convention(Order::EXTRINSIC, Direction::ACTIVE);
+
+  SUBCASE("Chunks and probes of parallel conversions") {
+    setTraceThreadName("main \"thread\"");
+    startTrace();
+    CHECK(tracing() == static_cast<bool>(EULER_INSTRUMENTATION));
+    {
+      ThreadPool pool(2);
+      toRotationMatrix("zyx", angles.data(), angles.size(), convention, R.data(), pool);
+    }
+    {
+      const TraceScope scope("custom", "test", 42);
+    }
+    stopTrace();
+    CHECK_FALSE(tracing());
+
+    // Nothing is recorded once stopped
+    toRotationMatrix("zyx", angles.data(), angles.size(), convention, R.data());
+
+    REQUIRE(writeTrace(path));
+    const std::string trace = readFile(path);
+    CHECK(trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[") == 0);
+    if (EULER_INSTRUMENTATION) {
+      CHECK(occurrences(trace, "\"name\":\"chunk\"") == 3);
+      CHECK(occurrences(trace, "\"name\":\"toRotationMatrix\"") == 3);
+      CHECK(occurrences(trace, "\"args\":{\"records\":2048}") == 6);
+      CHECK(occurrences(trace, "\"name\":\"custom\",\"cat\":\"test\"") == 1);
+      CHECK(occurrences(trace, "\"args\":{\"name\":\"main \\\"thread\\\"\"}") == 1);
+    }
+
+    // A new trace starts empty
+    startTrace();
+    stopTrace();
+    REQUIRE(writeTrace(path));
+    CHECK(occurrences(readFile(path), "\"ph\":\"X\"") == 0);
+    std::remove(path.c_str());
+  }
+
+  SUBCASE("Unwritable files") { CHECK_FALSE(writeTrace("no/such/directory/trace.json")); }
+}